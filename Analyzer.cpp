@@ -13,338 +13,1007 @@
 
 #include "Analyzer.h"
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <set>
 #include <sstream>
+#include <thread>
 
 #include "BioUtils.h"
+#include "Checkpoint.h"
 #include "Event.h"
+#include "GenotypeCacheWriter.h"
 #include "GenotypingResults.h"
 #include "Utilities.h"
 
 /** Analyzer constructor. **/
 Analyzer::Analyzer( const std::string& nameOfInputFile,
-    const Settings* settings, const::std::string& name_of_output_file): settings_(settings) {
-  m_inputFile.open( nameOfInputFile.c_str() );
-  output_file_.open(name_of_output_file.c_str());
-  if (!m_inputFile) { // input file does not exist
+    const Settings* settings, const::std::string& name_of_output_file):
+    output_writer_(name_of_output_file,
+        !settings->GetNameOfResumeFile().empty()),
+    instrumentation_(nameOfInputFile, settings->GetNameOfReportFile(),
+        settings->GetSecondsBetweenReports()),
+    m_inputFile(nameOfInputFile, settings->GetNumberOfThreads()),
+    name_of_input_file_(nameOfInputFile), settings_(settings),
+    classifier_(settings),
+    resume_offset_(0), is_calibration_pass_(false) {
+  if (!m_inputFile.IsOpen()) { // input file does not exist
     std::cout << "Input file does not exist.\n";
         exit(-1);
   }
-  unknown_calls_ = 0;
-  homref_calls_ = 0;
-  variant_calls_ = 0;
-
-  unknown_count_ = 0;
-  m_mendelianCorrect = 0;
-  m_mendelianError = 0;
-  all_homref_ = 0;
-  event_count_ = 0;
-  all_genotyped_  = 0;
-  Quality default_quality;
-  eventtype_qualities_[kSnp] = default_quality;
-  eventtype_qualities_[kUnknown] = default_quality;
-  eventtype_qualities_[kIns] = default_quality;
-  eventtype_qualities_[kDel] = default_quality;
-  eventtype_qualities_[kRpl] = default_quality;
-
+  const std::vector<std::string>& regions = settings_->GetRegions();
+  for (size_t index = 0; index < regions.size(); ++index) {
+    regions_.AddRegion(regions[index]);
+  }
+  if (!settings_->GetNameOfBedFile().empty()) {
+    regions_.AddBedFile(settings_->GetNameOfBedFile());
+  }
+  if (!settings_->GetNameOfPedFile().empty()) {
+    pedigree_.ReadPedFile(settings_->GetNameOfPedFile());
+  }
+  if (!settings_->GetNameOfConfigurationsFile().empty()) {
+    ReadConfigurations(settings_->GetNameOfConfigurationsFile());
+  }
+  configuration_statistics_.resize(configurations_.size());
 }
 
 /** Destructor **/
 Analyzer::~Analyzer() {
-  m_inputFile.close();
-}
-
-/** Updates the Mendelian error map. **/
-void Analyzer::UpdateMendelianErrorMap(const Genotype& firstParentGenotype,
-    const Genotype& secondParentGenotype, const Genotype& childGenotype) {
-
-  // first sort parents' genotypes
-  std::string first_parent_as_string = firstParentGenotype.AsString();
-  std::string second_parent_as_string = secondParentGenotype.AsString();
-  std::string parents_string =
-      (first_parent_as_string <= second_parent_as_string) ?
-          (first_parent_as_string + "," + second_parent_as_string) :
-          (second_parent_as_string + "," + first_parent_as_string);
-  // Now construct total identifier string
-  std::string id_string = parents_string + " => " + childGenotype.AsString();
-  if (Utilities::MapContainsKey(me_map_, id_string)) {
-    me_map_[id_string]++;
-  }
-  else {
-    me_map_[id_string] = 1;
+  for (size_t index = 0; index < record_caches_.size(); ++index) {
+    delete record_caches_[index];
   }
-
-
 }
 
-/** Scores a vector of genotypes as correct or incorrect **/
-void Analyzer::ScoreAsCorrect(
-    const std::vector<GenotypingResults>& genotyping_results,
-    const Event& event,
-    bool is_correct,
-    const std::string& line) {
-  for (size_t index = 0; index < genotyping_results.size(); index++) {
-
-    // first: score VAFs
-    double vaf = genotyping_results[index].GetSupport().GetVaf();
-    if (vaf >= 0.0) {
-      int vaf_bin_index = vaf * NUM_VAF_BINS;
-      vaf_qualities_[vaf_bin_index].AddOccurrence(is_correct);
-    }
-
-    // then: score coverage
-    int total_support =
-        genotyping_results[index].GetSupport().GetTotalSupport();
-    static const int COVERAGE_RESOLUTION = 5;
-    static const int MAX_SUPPORT = 200;
-    if (total_support > MAX_SUPPORT) {
-      total_support = MAX_SUPPORT;
-    }
-    int support_bin_index = total_support / COVERAGE_RESOLUTION;
-    coverage_qualities_[support_bin_index].AddOccurrence(is_correct);
-
-
-    // finally: score event
-    EventType eventtype = event.GetType();
-    if (!Utilities::MapContainsKey(eventtype_qualities_, eventtype)) {
-      Quality new_quality;
-      eventtype_qualities_[eventtype] = new_quality;
+/** Aborts if a record with 'number_of_samples' samples lacks a member of a
+ * trio of 'trio_plan'. **/
+void Analyzer::RequireTrioSamples(const TrioPlan& trio_plan,
+    int number_of_samples) const {
+  for (size_t trio_index = 0; trio_index < trio_plan.trios.size();
+      ++trio_index) {
+    const Trio& trio = trio_plan.trios[trio_index];
+    if (std::max(trio.father, std::max(trio.mother, trio.child)) >=
+        number_of_samples) {
+      std::cout << "A record has fewer samples than the header!\n";
+      exit( -1 );
     }
-    eventtype_qualities_[eventtype].AddOccurrence(is_correct);
   }
 }
 
-/** Scores a vector of genotypes as incorrect **/
-
-
-/** classifies/counts the trio as having unknown, correct or incorrect Mendelian
- * inheritance. **/
-bool Analyzer::ClassifyTrio(const std::vector<GenotypingResults>& genotyping_results,
-     const Event& event, const std::string& line, bool* is_genotypable) {
-  const Genotype& firstParentGenotype = genotyping_results[0].GetGenotype();
-  const Genotype& secondParentGenotype = genotyping_results[1].GetGenotype();
-  const Genotype& childGenotype = genotyping_results[2].GetGenotype();
-  //std::cout << firstParentGenotype << " " << secondParentGenotype << " " << childGenotype << "\n";
-  //Utilities::Pause();
-  *is_genotypable = BioUtils::canAssessMendelianCorrectness(firstParentGenotype, secondParentGenotype,
-      childGenotype);
-  //std::cout << *is_genotypable << "]IG\n";
-  //Utilities::Pause();
-  if (*is_genotypable) {
-    if (firstParentGenotype.IsHomRef() && secondParentGenotype.IsHomRef() &&
-        childGenotype.IsHomRef()) {
-      all_homref_++;
-    }
-    else if (BioUtils::canBeMendelianCorrect(firstParentGenotype, secondParentGenotype, childGenotype)) {
-      m_mendelianCorrect++;
-      ScoreAsCorrect(genotyping_results, event, true, line);
-      return true;
-    } else {
-      m_mendelianError++;
-      ScoreAsCorrect(genotyping_results, event, false, line);
-      UpdateMendelianErrorMap(firstParentGenotype, secondParentGenotype, childGenotype);
-      //SystematicDisplay(line);
-      //pause();
-
-        //        std::cout << line << std::endl;
-        //        char ch;
-        //        std::cin >> ch;
+/** Finds the regions that a record overlaps, from its position to the end
+ * of its reference allele. **/
+void Analyzer::FindRegions(const VcfRecord& record, const Span& reference,
+    std::vector<int>* region_indices) const {
+  long long position = BioUtils::GetPosition(record);
+  long long end_position = position +
+      std::max<long long>(reference.size(), 1) - 1;
+  regions_.GetOverlappingRegions(record.GetColumn(kChrom), position,
+      end_position, region_indices);
+}
+
+/** Is the event analyzed by any of the extra configurations? **/
+bool Analyzer::IsInAConfiguration(const Event& event) const {
+  for (size_t index = 0; index < configurations_.size(); ++index) {
+    if (configurations_[index].settings.ShouldAnalyzeVariant(event)) {
       return true;
     }
-  } else { // if cannot assess Mendelian correctness
-    unknown_count_++;
-    //std::cout << "UK";
-    //Utilities::Pause();
   }
   return false;
 }
 
-/**  analyze the samples associated with a particular structural variant.
- * Returns true if any of the samples has been called with sufficient confidence
- * as containing an alt-allele. **/
-bool Analyzer::AnalyzeSamples(std::stringstream& ss, const Event& event, const std::string& line,
-    bool* all_genotyped, std::stringstream& buffer_ss) {
-
-  double MIN_CONFIDENCE = settings_->GetMinConfidence();
-
-  std::vector<GenotypingResults> genotyping_results_of_trio;
-  bool success = false;
-
-  int number_of_genotyped_trios = 0;
-  while (true) {
-     std::string genotypeWithReadDepths;
-     ss >> genotypeWithReadDepths;
-     if (ss.fail()) {
-       break;
-     }
-//std::cout <<"X1";
-     GenotypingResults genotyping_results(genotypeWithReadDepths, settings_->isPindel());
-     double confidence = call_confidence_estimator_.GetConfidence(event, genotyping_results.GetSupport());
-     //std::cout << line << "[]" << confidence << "\n";
-     //Utilities::Pause();
-     if (confidence < MIN_CONFIDENCE || genotyping_results.GetGenotype().IsUnknown()) {
-       genotyping_results.GetGenotype().SetToUnknown();
-       unknown_calls_++;
-     } else {
-       //std::cout << "GT:" << genotyping_results.GetGenotype() << "\n";
-       //Utilities::Pause();
-
-       if (genotyping_results.GetGenotype().IsHomRef()) {
-         homref_calls_++;
-       }
-       else {
-         variant_calls_++;
-         success = true;
-       }
-     }
-
-     buffer_ss << "\t" << genotyping_results;
-     genotyping_results_of_trio.push_back(genotyping_results);
-     bool this_genotyped = false;
-     if (genotyping_results_of_trio.size() == 3) {
-       ClassifyTrio(genotyping_results_of_trio, event, line, &this_genotyped);
-       *all_genotyped = *all_genotyped && this_genotyped;
-       genotyping_results_of_trio.clear();
-     }
-   }
-   if (genotyping_results_of_trio.size() != 0 ) {
-     std::cout << "This does not seem to be trio data!\n";
-     exit( -1 );
-   }
-   //std::cout <<"X2";
-   ++trio_count_[number_of_genotyped_trios];
-   return success;
+/** Parses the samples of a record that are in a trio of 'trio_plan', and
+ * estimates the confidence in the call of each. The calls are not judged
+ * yet: each configuration does that with its own minimal confidence. **/
+void Analyzer::ReadSamples(const VcfRecord& record, const Event& event,
+    const FormatPlan& format_plan, const TrioPlan& trio_plan,
+    ParsedSamples* samples, StageTimer* stage_timer) const {
+  RequireTrioSamples(trio_plan, record.GetNumberOfSamples());
+
+  stage_timer->Switch(kParsingStage);
+  classifier_.ReadSamples(record, format_plan, trio_plan, samples);
+  EstimateConfidences(event, samples, stage_timer);
+}
+
+/** Estimates the confidence in the call of each of the parsed samples. **/
+void Analyzer::EstimateConfidences(const Event& event,
+    ParsedSamples* samples, StageTimer* stage_timer) const {
+  stage_timer->Switch(kConfidenceStage);
+  classifier_.EstimateConfidences(call_confidence_estimator_, event,
+      samples);
 }
 
 /** Shows the counts of different Mendelian errors. **/
 void Analyzer::ShowMendelianErrorMap() const {
-  for (std::map<std::string, int>::const_iterator it = me_map_.begin();
-      it != me_map_.end(); ++it) {
+  std::map<std::string, int> me_map =
+      statistics_.mendelian_errors.GetCountsPerDescription();
+  for (std::map<std::string, int>::const_iterator it = me_map.begin();
+      it != me_map.end(); ++it) {
     std::cout << it->first << ": " << it->second << std::endl;
   }
 }
 
+/** Shows the counts per region, and writes them to region_results_1.txt.
+ * **/
+void Analyzer::OutputRegionResults() const {
+  std::ofstream region_file("region_results_1.txt");
+  region_file << "region\tchromosome\tstart\tend\tevents\tunknown\t" <<
+      "all_homref\tmendelian_correct\tmendelian_error\terror_rate\n";
+  std::cout << "Results per region (region: events, Mendelian correct, " <<
+      "Mendelian error, error rate)\n";
+  for (int index = 0; index < regions_.GetNumberOfRegions(); ++index) {
+    const GenomicRegion& region = regions_.GetRegion(index);
+    RegionCounts counts;
+    if (static_cast<size_t>(index) < statistics_.region_counts.size()) {
+      counts = statistics_.region_counts[index];
+    }
+    std::stringstream error_rate;
+    if (counts.mendelian_correct + counts.mendelian_error > 0) {
+      error_rate << 100.0 * counts.mendelian_error /
+          (counts.mendelian_correct + counts.mendelian_error) << "%";
+    }
+    else {
+      error_rate << "NA";
+    }
+    std::cout << region.name << ": " << counts.event_count << " " <<
+        counts.mendelian_correct << " " << counts.mendelian_error << " " <<
+        error_rate.str() << "\n";
+    region_file << region.name << "\t" << region.chromosome << "\t" <<
+        region.start << "\t" << region.end << "\t" << counts.event_count <<
+        "\t" << counts.unknown_count << "\t" << counts.all_homref << "\t" <<
+        counts.mendelian_correct << "\t" << counts.mendelian_error << "\t" <<
+        error_rate.str() << "\n";
+  }
+  region_file.close();
+  std::cout << "\n";
+}
+
 /** Output the bins: what is the qualuity per bin? (currently, bins defined
  * to contain VAF)
  */
 void Analyzer::OutputBins() const {
-  std::map<EventType, Quality> eventtype_qualities;
+  const int NUM_VAF_BINS = Statistics::NUM_VAF_BINS;
+  const int MAX_SUPPORT = Statistics::MAX_SUPPORT;
+  const int COVERAGE_RESOLUTION = Statistics::COVERAGE_RESOLUTION;
+  const Quality* eventtype_qualities = statistics_.eventtype_qualities;
 
   std::cout << "VAF qualities\n";
-  std::ofstream vaf_file("vaf_qualities_1.txt");
-  vaf_file << NUM_VAF_BINS << "\n";
   for (int index = 0; index <= NUM_VAF_BINS; index++) {
       std::cout << index / static_cast<double>(NUM_VAF_BINS) << "-" <<
           (index + 1) / static_cast<double>(NUM_VAF_BINS) << ": " <<
-          vaf_qualities_[index] << "\n";
-      vaf_file << index << "\t" <<
-          vaf_qualities_[index].GetCorrectnessFraction() << "\n";
+          statistics_.vaf_qualities[index] << "\n";
   }
-  vaf_file.close();
   std::cout << "\n";
 
   std::cout << "Coverage qualities\n";
-  std::ofstream coverage_file("coverage_qualities_1.txt");
-  coverage_file << MAX_SUPPORT << "\t" <<  COVERAGE_RESOLUTION << "\n";
   for (int index = 0; index <= MAX_SUPPORT / COVERAGE_RESOLUTION; index++) {
     std::cout << index * COVERAGE_RESOLUTION << "-" <<
       (index + 1) *  COVERAGE_RESOLUTION << ": " <<
-      coverage_qualities_[index] << "\n";
-    coverage_file << index << "\t" <<
-        coverage_qualities_[index].GetCorrectnessFraction() << "\n";
+      statistics_.coverage_qualities[index] << "\n";
   }
-  coverage_file.close();
   std::cout << "\n";
 
-  std::ofstream event_file("event_qualities_1.txt");
   std::cout << "Event-type qualities";
-  std::cout << "SNP: " << eventtype_qualities_.find(kSnp)->second << "\n";
-  std::cout << "INS: " << eventtype_qualities_.find(kIns)->second  << "\n";
-  std::cout << "DEL: " << eventtype_qualities_.find(kDel)->second  << "\n";
-  std::cout << "RPL: " << eventtype_qualities_.find(kRpl)->second  << "\n";
-  std::cout << "UNKNOWN: " << eventtype_qualities_.find(kUnknown)->second << "\n";
-
-  event_file << "SNP: " << eventtype_qualities_.find(kSnp)->second.GetCorrectnessFraction() << "\n";
-  event_file << "INS: " << eventtype_qualities_.find(kIns)->second.GetCorrectnessFraction()  << "\n";
-  event_file << "DEL: " << eventtype_qualities_.find(kDel)->second.GetCorrectnessFraction()  << "\n";
-  event_file << "RPL: " << eventtype_qualities_.find(kRpl)->second.GetCorrectnessFraction()  << "\n";
-  event_file << "UNKNOWN: " << eventtype_qualities_.find(kUnknown)->second.GetCorrectnessFraction() << "\n";
+  std::cout << "SNP: " << eventtype_qualities[kSnp] << "\n";
+  std::cout << "INS: " << eventtype_qualities[kIns]  << "\n";
+  std::cout << "DEL: " << eventtype_qualities[kDel]  << "\n";
+  std::cout << "RPL: " << eventtype_qualities[kRpl]  << "\n";
+  std::cout << "UNKNOWN: " << eventtype_qualities[kUnknown] << "\n";
+
+  WriteBins(statistics_, "1");
+}
+
+/** Writes the correctness fraction per bin to vaf_qualities_<suffix>.txt,
+ * coverage_qualities_<suffix>.txt and event_qualities_<suffix>.txt. **/
+void Analyzer::WriteBins(const Statistics& statistics,
+    const std::string& suffix) const {
+  const int NUM_VAF_BINS = Statistics::NUM_VAF_BINS;
+  const int MAX_SUPPORT = Statistics::MAX_SUPPORT;
+  const int COVERAGE_RESOLUTION = Statistics::COVERAGE_RESOLUTION;
+  const Quality* eventtype_qualities = statistics.eventtype_qualities;
+
+  std::ofstream vaf_file(("vaf_qualities_" + suffix + ".txt").c_str());
+  vaf_file << NUM_VAF_BINS << "\n";
+  for (int index = 0; index <= NUM_VAF_BINS; index++) {
+      vaf_file << index << "\t" <<
+          statistics.vaf_qualities[index].GetCorrectnessFraction() << "\n";
+  }
+  vaf_file.close();
+
+  std::ofstream coverage_file(
+      ("coverage_qualities_" + suffix + ".txt").c_str());
+  coverage_file << MAX_SUPPORT << "\t" <<  COVERAGE_RESOLUTION << "\n";
+  for (int index = 0; index <= MAX_SUPPORT / COVERAGE_RESOLUTION; index++) {
+    coverage_file << index << "\t" <<
+        statistics.coverage_qualities[index].GetCorrectnessFraction() << "\n";
+  }
+  coverage_file.close();
+
+  std::ofstream event_file(("event_qualities_" + suffix + ".txt").c_str());
+  event_file << "SNP: " << eventtype_qualities[kSnp].GetCorrectnessFraction() << "\n";
+  event_file << "INS: " << eventtype_qualities[kIns].GetCorrectnessFraction()  << "\n";
+  event_file << "DEL: " << eventtype_qualities[kDel].GetCorrectnessFraction()  << "\n";
+  event_file << "RPL: " << eventtype_qualities[kRpl].GetCorrectnessFraction()  << "\n";
+  event_file << "UNKNOWN: " << eventtype_qualities[kUnknown].GetCorrectnessFraction() << "\n";
   event_file.close();
 }
 
+/** Shows how the call rate and the Mendelian error rate change with the
+ * minimal confidence, and writes the counts for all thresholds of the sweep
+ * to confidence_sweep.txt. **/
+void Analyzer::OutputConfidenceSweep() const {
+  const ConfidenceSweep& sweep = statistics_.confidence_sweep;
+  const int STEPS_PER_SHOWN_STEP = 10;
+  std::ofstream sweep_file("confidence_sweep.txt");
+  sweep_file << "min_confidence\tunknown_calls\thomref_calls\t" <<
+      "variant_calls\tcall_rate\tevents\tunknown\tall_homref\t" <<
+      "mendelian_correct\tmendelian_error\terror_rate\n";
+  std::cout << "\nConfidence sweep (min confidence: call rate, Mendelian " <<
+      "error rate); all thresholds are in confidence_sweep.txt\n";
+  for (int step = 0; step <= ConfidenceSweep::NUMBER_OF_STEPS; ++step) {
+    long long unknown_calls = sweep.GetCount(kSweepUnknownCalls, step);
+    long long homref_calls = sweep.GetCount(kSweepHomrefCalls, step);
+    long long variant_calls = sweep.GetCount(kSweepVariantCalls, step);
+    long long mendelian_correct = sweep.GetCount(kSweepCorrectTrios, step);
+    long long mendelian_error = sweep.GetCount(kSweepErrorTrios, step);
+    std::stringstream call_rate;
+    if (unknown_calls + homref_calls + variant_calls > 0) {
+      call_rate << 100.0 * (homref_calls + variant_calls) /
+          (unknown_calls + homref_calls + variant_calls) << "%";
+    }
+    else {
+      call_rate << "NA";
+    }
+    std::stringstream error_rate;
+    if (mendelian_correct + mendelian_error > 0) {
+      error_rate << 100.0 * mendelian_error /
+          (mendelian_correct + mendelian_error) << "%";
+    }
+    else {
+      error_rate << "NA";
+    }
+    double threshold = ConfidenceSweep::GetThreshold(step);
+    if (step % STEPS_PER_SHOWN_STEP == 0) {
+      std::cout << threshold << ": " << call_rate.str() << " " <<
+          error_rate.str() << "\n";
+    }
+    sweep_file << threshold << "\t" << unknown_calls << "\t" <<
+        homref_calls << "\t" << variant_calls << "\t" << call_rate.str() <<
+        "\t" << sweep.GetCount(kSweepEvents, step) << "\t" <<
+        sweep.GetCount(kSweepUnknownTrios, step) << "\t" <<
+        sweep.GetCount(kSweepAllHomrefTrios, step) << "\t" <<
+        mendelian_correct << "\t" << mendelian_error << "\t" <<
+        error_rate.str() << "\n";
+  }
+  sweep_file.close();
+}
+
+/** Shows the counts per extra configuration, and writes them to
+ * configuration_results.txt; the bins of each configuration go to files
+ * named after it, like those of the main analysis. **/
+void Analyzer::OutputConfigurationResults() const {
+  std::ofstream configuration_file("configuration_results.txt");
+  configuration_file << "configuration\tmin_confidence\tevents\t" <<
+      "unknown_calls\thomref_calls\tvariant_calls\tunknown\tall_homref\t" <<
+      "mendelian_correct\tmendelian_error\terror_rate\n";
+  std::cout << "\nResults per configuration (configuration: events, " <<
+      "Mendelian correct, Mendelian error, error rate)\n";
+  for (size_t index = 0; index < configurations_.size(); ++index) {
+    const Configuration& configuration = configurations_[index];
+    const Statistics& statistics = configuration_statistics_[index];
+    std::stringstream error_rate;
+    if (statistics.mendelian_correct + statistics.mendelian_error > 0) {
+      error_rate << 100.0 * statistics.mendelian_error /
+          (statistics.mendelian_correct + statistics.mendelian_error) << "%";
+    }
+    else {
+      error_rate << "NA";
+    }
+    std::cout << configuration.name << ": " << statistics.event_count <<
+        " " << statistics.mendelian_correct << " " <<
+        statistics.mendelian_error << " " << error_rate.str() << "\n";
+    configuration_file << configuration.name << "\t" <<
+        configuration.settings.GetMinConfidence() << "\t" <<
+        statistics.event_count << "\t" << statistics.unknown_calls << "\t" <<
+        statistics.homref_calls << "\t" << statistics.variant_calls << "\t" <<
+        statistics.unknown_count << "\t" << statistics.all_homref << "\t" <<
+        statistics.mendelian_correct << "\t" << statistics.mendelian_error <<
+        "\t" << error_rate.str() << "\n";
+    WriteBins(statistics, configuration.name);
+  }
+  configuration_file.close();
+}
+
 /** show the counting results to the user. **/
 void Analyzer::ShowResults() const {
   std::cout << std::endl;
-  std::cout << "Number of events: " << event_count_ << std::endl;
+  std::cout << "Number of events: " << statistics_.event_count << std::endl;
   std::cout << "Number of events with 0, 1, 2 and 3 trios genotyped: " <<
-      trio_count_[0] << " " << trio_count_[1] << " " <<
-      trio_count_[2] << " " << trio_count_[3] << std::endl;
-  std::cout << "Unknown calls: " << unknown_calls_ << "\n";
-  std::cout << "Homref calls: " << homref_calls_ << "\n";
-  std::cout << "Variant calls: " << variant_calls_ << "\n";
-  std::cout << "Number of events with all samples genotyped: " << all_genotyped_ << std::endl;
-  std::cout << "Unknown: " << unknown_count_ << std::endl;
-  std::cout << "Pure homref trios: " << all_homref_ <<std::endl;
-  std::cout << "Mendelian correct: " << m_mendelianCorrect << std::endl;
-  std::cout << "Mendelian error: " << m_mendelianError << std::endl;
+      statistics_.trio_count[0] << " " << statistics_.trio_count[1] << " " <<
+      statistics_.trio_count[2] << " " << statistics_.trio_count[3] << std::endl;
+  std::cout << "Unknown calls: " << statistics_.unknown_calls << "\n";
+  std::cout << "Homref calls: " << statistics_.homref_calls << "\n";
+  std::cout << "Variant calls: " << statistics_.variant_calls << "\n";
+  if (statistics_.unstored_allele_records > 0) {
+    std::cout << "Records with more than " << Event::MAX_STORED_ALT_ALLELES <<
+        " alt alleles (only the first " << Event::MAX_STORED_ALT_ALLELES <<
+        " are analyzed): " << statistics_.unstored_allele_records << "\n";
+  }
+  std::cout << "Number of events with all samples genotyped: " << statistics_.all_genotyped << std::endl;
+  std::cout << "Unknown: " << statistics_.unknown_count << std::endl;
+  std::cout << "Pure homref trios: " << statistics_.all_homref <<std::endl;
+  std::cout << "Mendelian correct: " << statistics_.mendelian_correct << std::endl;
+  std::cout << "Mendelian error: " << statistics_.mendelian_error << std::endl;
   std::cout << "Mendelian error rate: "
-      << 100.0 * m_mendelianError / (m_mendelianError + m_mendelianCorrect) << "%\n";
+      << 100.0 * statistics_.mendelian_error / (statistics_.mendelian_error + statistics_.mendelian_correct) << "%\n";
   std::cout << "Mendelian error rate including all-homref trios: "
-        << 100.0 * m_mendelianError / (m_mendelianError + m_mendelianCorrect + all_homref_) << "%\n";
+        << 100.0 * statistics_.mendelian_error / (statistics_.mendelian_error + statistics_.mendelian_correct + statistics_.all_homref) << "%\n";
   ShowMendelianErrorMap();
+  if (!regions_.IsEmpty()) {
+    OutputRegionResults();
+  }
   OutputBins();
+  if (settings_->IsSweeping()) {
+    OutputConfidenceSweep();
+  }
+  if (!configurations_.empty()) {
+    OutputConfigurationResults();
+  }
 }
 
 
 
-/** Reads the input file, analyzes the trios found therein for Mendelian
- * violations. **/
-void Analyzer::analyze() {
+/** Classifies a record of which the samples have been read: for the main
+ * analysis if 'should_analyze_variant', which writes the record to
+ * 'output_batch' if it is an event, and for every configuration that
+ * analyzes its event. In the first pass of a calibration, only the main
+ * analysis counts the record. **/
+void Analyzer::AnalyzeRecord(const Span& fixed_columns, const Event& event,
+    const TrioPlan& trio_plan, bool should_analyze_variant,
+    const ParsedSamples& samples, std::vector<signed char>* calls,
+    Statistics* statistics,
+    std::vector<Statistics>* configuration_statistics,
+    std::string* output_batch, StageTimer* stage_timer) const {
+  stage_timer->Switch(kClassificationStage);
+  if (is_calibration_pass_) {
+    // only the qualities of the main analysis are needed from this pass;
+    // the rest waits for the calibrated confidences
+    if (should_analyze_variant) {
+      classifier_.ClassifySamples(samples, event, trio_plan, *settings_,
+          calls, statistics);
+    }
+    return;
+  }
+  if (should_analyze_variant && classifier_.ClassifySamples(samples, event,
+      trio_plan, *settings_, calls, statistics)) {
+    stage_timer->Switch(kOutputStage);
+    classifier_.AppendRecord(fixed_columns, samples, *calls, output_batch);
+    stage_timer->Switch(kClassificationStage);
+  }
+  if (should_analyze_variant && settings_->IsSweeping()) {
+    classifier_.AddToSweep(samples, event, trio_plan,
+        &statistics->confidence_sweep);
+  }
+  for (size_t index = 0; index < configurations_.size(); ++index) {
+    const Settings& configuration = configurations_[index].settings;
+    if (configuration.ShouldAnalyzeVariant(event)) {
+      classifier_.ClassifySamples(samples, event, trio_plan, configuration,
+          calls, &(*configuration_statistics)[index]);
+    }
+  }
+}
+
+/** Analyzes the records of 'cache', from the first one on. The analyzed
+ * records are added to 'output_batch', which is handed to the output writer
+ * as stream 0 whenever it is full. **/
+template <class Cache>
+void Analyzer::AnalyzeCachedRecords(Cache* cache, std::string* output_batch,
+    StageTimer* stage_timer) {
+  TrioPlan consecutive_trio_plan;
+  const TrioPlan* trio_plan = pedigree_.IsLoaded() ?
+      &pedigree_.GetTrioPlan() : &consecutive_trio_plan;
+  CachedRecord record;
+  VcfRecord fixed_columns;
+  std::vector<int> region_indices;
+  ParsedSamples samples;
+  std::vector<signed char> calls;
+  cache->Rewind();
+  for (stage_timer->Switch(kIoStage); cache->Next(&record);
+      stage_timer->Switch(kIoStage)) {
+    if (output_batch->size() >= OutputWriter::BATCH_SIZE) {
+      stage_timer->Switch(kOutputStage);
+      output_writer_.Submit(0, output_batch);
+      output_batch->reserve(OutputWriter::BATCH_SIZE + (1 << 16));
+      stage_timer->UpdateCpuTime();
+    }
+    stage_timer->Switch(kParsingStage);
+    stage_timer->AddRecord();
+    if (!regions_.IsEmpty()) {
+      fixed_columns.Parse(record.fixed_columns);
+      FindRegions(fixed_columns, record.reference, &region_indices);
+      if (region_indices.empty()) {
+        continue;
+      }
+    }
+    Event event(record.reference, record.alt);
+    // the second pass of a calibration has counted these already
+    if (event.HasUnstoredAltAlleles() &&
+        (is_calibration_pass_ || !settings_->IsCalibrating())) {
+      ++statistics_.unstored_allele_records;
+    }
+    bool should_analyze_variant = settings_->ShouldAnalyzeVariant(event);
+    if (!should_analyze_variant && !IsInAConfiguration(event)) {
+      continue;
+    }
+    if (!pedigree_.IsLoaded() && record.number_of_samples !=
+        static_cast<int>(consecutive_trio_plan.is_sample_needed.size())) {
+      Pedigree::MakeConsecutiveTrioPlan(record.number_of_samples,
+          &consecutive_trio_plan);
+    }
+    RequireTrioSamples(*trio_plan, record.number_of_samples);
+    cache->ReadSamples(&record);
+    // the cache holds either all samples or only the needed ones, in the
+    // order of their columns; only the needed ones are kept
+    bool has_all_samples = static_cast<int>(record.results.size()) ==
+        record.number_of_samples;
+    samples.results_index.assign(record.number_of_samples, -1);
+    int number_of_results = 0;
+    for (int sample_index = 0; sample_index < record.number_of_samples;
+        ++sample_index) {
+      if (trio_plan->IsSampleNeeded(sample_index)) {
+        if (has_all_samples && number_of_results != sample_index) {
+          record.results[number_of_results] = record.results[sample_index];
+        }
+        samples.results_index[sample_index] = number_of_results++;
+      }
+    }
+    record.results.erase(record.results.begin() + number_of_results,
+        record.results.end());
+    samples.results.swap(record.results);
+    EstimateConfidences(event, &samples, stage_timer);
+
+    RegionCounts counts_before;
+    if (!region_indices.empty()) {
+      counts_before = statistics_.GetRegionCounts();
+    }
+    AnalyzeRecord(record.fixed_columns, event, *trio_plan,
+        should_analyze_variant, samples, &calls, &statistics_,
+        &configuration_statistics_, output_batch, stage_timer);
+    for (size_t index = 0; index < region_indices.size(); ++index) {
+      statistics_.AddToRegion(region_indices[index], counts_before);
+    }
+  }
+}
+
+/** The second pass of a calibration: analyzes the records that the first
+ * pass kept, in the order of the input file. **/
+void Analyzer::AnalyzeRecordCaches() {
+  output_writer_.Start(1, instrumentation_.AddThread("output writer"));
+  StageTimer stage_timer(instrumentation_.AddThread("analysis of cache"));
+  std::string output_batch;
+  for (size_t index = 0; index < record_caches_.size(); ++index) {
+    AnalyzeCachedRecords(record_caches_[index], &output_batch, &stage_timer);
+  }
+  stage_timer.Switch(kOutputStage);
+  output_writer_.Submit(0, &output_batch);
+  output_writer_.CloseStream(0);
+  output_writer_.Finish();
+}
+
+/** Analyzes the cache file instead of the input file; the cache is written
+ * first if it does not exist yet, or if the input is not a regular file
+ * (which cannot be recognized again). With 'calibrate', both passes read
+ * the cache file. **/
+void Analyzer::AnalyzeGenotypeCache() {
+  const std::string& name_of_cache_file = settings_->GetNameOfCacheFile();
+  InputFileIdentity input_file;
+  bool is_regular_input = GenotypeCache::IdentifyInputFile(
+      name_of_input_file_, &input_file);
+  GenotypeCache cache;
+  if (!is_regular_input || !cache.Open(name_of_cache_file, input_file,
+      settings_->isPindel())) {
+    std::cout << "\nWriting cache file " << name_of_cache_file << "\n";
+    WriteGenotypeCache(name_of_cache_file, input_file,
+        instrumentation_.AddThread("writing cache"));
+    Utilities::Require(cache.Open(name_of_cache_file, input_file,
+        settings_->isPindel()), "Analyzer error: cannot read cache file '" +
+        name_of_cache_file + "'.");
+  }
+  else {
+    std::cout << "\nAnalyzing cache file " << name_of_cache_file << "\n";
+  }
+  std::string output_batch;
+  VcfScanner header_scanner(cache.GetHeaderLines());
+  Span line;
+  while (header_scanner.NextLine(&line)) {
+    ReadHeaderLine(line);
+  }
+  Utilities::Require(!pedigree_.IsLoaded() || pedigree_.IsResolved(),
+      "Analyzer error: the VCF file has no #CHROM line to match the "
+      "PED file with.");
+
+  StageTimer stage_timer(instrumentation_.AddThread("analysis of cache"));
+  if (is_calibration_pass_) {
+    // nothing is written in this pass
+    AnalyzeCachedRecords(&cache, &output_batch, &stage_timer);
+    EndCalibrationPass();
+  }
+  output_writer_.Start(1, instrumentation_.AddThread("output writer"));
+  output_batch.append(cache.GetHeaderLines().begin(),
+      cache.GetHeaderLines().size());
+  AnalyzeCachedRecords(&cache, &output_batch, &stage_timer);
+  stage_timer.Switch(kOutputStage);
+  output_writer_.Submit(0, &output_batch);
+  output_writer_.CloseStream(0);
+  output_writer_.Finish();
+}
+
+/** Reads the whole input file, and writes all of its records, with all of
+ * their samples, to a cache file of 'input_file'. **/
+void Analyzer::WriteGenotypeCache(const std::string& name_of_cache_file,
+    const InputFileIdentity& input_file, ThreadCounters* counters) {
+  StageTimer stage_timer(counters);
+  GenotypeCacheWriter writer(name_of_cache_file, input_file,
+      settings_->isPindel());
+  VcfRecord record;
+  FormatPlan format_plan;
+  CachedRecord cached_record;
+  Span line;
+  for (stage_timer.Switch(kIoStage); m_inputFile.NextLine(&line);
+      stage_timer.Switch(kIoStage)) {
+    stage_timer.Switch(kParsingStage);
+    stage_timer.AddBytes(line.size() + 1);
+    if (line.empty()) {
+      continue;
+    }
+    if (line[0] == '#') {
+      writer.AddHeaderLine(line);
+      continue;
+    }
+    record.Parse(line);
+    record.ParseSamples();
+    stage_timer.AddRecord();
+    format_plan.SetFormat(record.GetColumn(kFormat));
+    cached_record.fixed_columns = Span(line.begin(),
+        record.GetColumn(kInfo).end());
+    BioUtils::GetDataAboutVariant(record, &cached_record.reference,
+        &cached_record.alt);
+    cached_record.number_of_samples = record.GetNumberOfSamples();
+    cached_record.results.clear();
+    for (int sample_index = 0; sample_index < record.GetNumberOfSamples();
+        ++sample_index) {
+      cached_record.results.push_back(GenotypingResults(
+          record.GetSample(sample_index), record.GetDelimiters(),
+          format_plan, settings_->isPindel()));
+    }
+    stage_timer.Switch(kOutputStage);
+    writer.Add(cached_record);
+  }
+  stage_timer.Switch(kOutputStage);
+  writer.Finish();
+}
 
+/** Analyzes the lines handed out by 'scanner', adding the counts to
+ * 'statistics', and those of the extra configurations to
+ * 'configuration_statistics'. Header lines and analyzed records are collected in batches
+ * that go to the output writer as stream 'output_stream_index'. Several
+ * threads can run this at the same time on different scanners and streams.
+ * The time spent in each stage goes to 'counters' (if not NULL). **/
+void Analyzer::AnalyzeLines(VcfScanner* scanner, Statistics* statistics,
+    std::vector<Statistics>* configuration_statistics,
+    int output_stream_index, ThreadCounters* counters) {
+  StageTimer stage_timer(counters);
+  std::string output_batch;
+  output_batch.reserve(OutputWriter::BATCH_SIZE + (1 << 16));
   // for every line do
-  while (!m_inputFile.eof()) {
-    std::string line;
-    std::stringstream buffer_ss;
-    getline(m_inputFile, line );
-    //std::cout << line << std::endl;
+  VcfRecord record;
+  FormatPlan format_plan;
+  // without a PED file, the trios are the consecutive samples of each record
+  TrioPlan consecutive_trio_plan;
+  const TrioPlan* trio_plan = pedigree_.IsLoaded() ?
+      &pedigree_.GetTrioPlan() : &consecutive_trio_plan;
+  ParsedSamples samples;
+  std::vector<signed char> calls;
+  Span line;
+  std::vector<int> region_indices;
+  // in the first pass of a calibration, the records are kept for the second
+  RecordCache* record_cache = record_caches_.empty() ? NULL :
+      record_caches_[output_stream_index];
+  CachedRecord cached_record;
+  // the clock is only looked at every so many lines
+  bool is_checkpointing = !settings_->GetNameOfCheckpointFile().empty();
+  int lines_until_clock_check = LINES_PER_CLOCK_CHECK;
+  std::chrono::seconds checkpoint_interval(
+      settings_->GetSecondsBetweenCheckpoints());
+  std::chrono::steady_clock::time_point next_checkpoint =
+      std::chrono::steady_clock::now() + checkpoint_interval;
+  // reading the next line is I/O, also after a 'continue'
+  for (stage_timer.Switch(kIoStage); scanner->NextLine(&line);
+      stage_timer.Switch(kIoStage)) {
+    if (output_batch.size() >= OutputWriter::BATCH_SIZE) {
+      stage_timer.Switch(kOutputStage);
+      output_writer_.Submit(output_stream_index, &output_batch);
+      output_batch.reserve(OutputWriter::BATCH_SIZE + (1 << 16));
+      stage_timer.UpdateCpuTime();
+    }
+    stage_timer.Switch(kParsingStage);
+    stage_timer.AddBytes(line.size() + 1);
+    if (line.empty()) {
+      continue;
+    }
 
     const char START_OF_COMMENT_CHAR = '#';
     // skip lines beginning with '#'
     if (line[0] == START_OF_COMMENT_CHAR ) {
-      output_file_ << line << "\n";
+      ReadHeaderLine(line);
+      output_batch.append(line.begin(), line.size());
+      output_batch.push_back('\n');
       continue;
     }
 
-    std::stringstream ss, ss2;
-    ss << line;
-    // ss2 is for getting general event info to the output file;
-    ss2 << line;
-    for (int i = 0; i < 9; i++) {
-      std::string item;
-      ss2 >> item;
-      if (i != 0 ) {
-        buffer_ss << "\t";
+    if (is_checkpointing && --lines_until_clock_check == 0) {
+      lines_until_clock_check = LINES_PER_CLOCK_CHECK;
+      std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now();
+      if (now >= next_checkpoint) {
+        stage_timer.Switch(kOutputStage);
+        WriteCheckpoint(scanner->GetOffsetOfLine(), *statistics,
+            *configuration_statistics, output_stream_index, &output_batch);
+        output_batch.reserve(OutputWriter::BATCH_SIZE + (1 << 16));
+        next_checkpoint = now + checkpoint_interval;
+        stage_timer.Switch(kParsingStage);
       }
-      buffer_ss << item;
     }
-    //std::cout << buffer_ss.str() << "]B";
-    //Utilities::Pause();
-    std::string refString, altString;
-    BioUtils::GetDataAboutVariant(ss, refString, altString);
+
+    // only the fixed columns are split here; the sample columns are split
+    // once the record has passed the region and type filters
+    record.Parse(line);
+    stage_timer.AddRecord();
+
+    Span refString, altString;
+    BioUtils::GetDataAboutVariant(record, &refString, &altString);
+    if (!regions_.IsEmpty()) {
+      FindRegions(record, refString, &region_indices);
+      if (region_indices.empty()) {
+        continue;
+      }
+    }
+    RegionCounts counts_before;
+    if (!region_indices.empty()) {
+      counts_before = statistics->GetRegionCounts();
+    }
+
     Event event(refString, altString);
+    if (event.HasUnstoredAltAlleles()) {
+      ++statistics->unstored_allele_records;
+    }
     bool should_analyze_variant = settings_->ShouldAnalyzeVariant(event);
-    if (should_analyze_variant) {
-      bool all_genotyped;
-      bool at_least_one_sample_analyzable = AnalyzeSamples(ss, event, line, &all_genotyped, buffer_ss);
-      if (all_genotyped) {
-        ++all_genotyped_;
+    if (should_analyze_variant || IsInAConfiguration(event)) {
+      record.ParseSamples();
+      format_plan.SetFormat(record.GetColumn(kFormat));
+      if (!pedigree_.IsLoaded() && record.GetNumberOfSamples() !=
+          static_cast<int>(consecutive_trio_plan.is_sample_needed.size())) {
+        Pedigree::MakeConsecutiveTrioPlan(record.GetNumberOfSamples(),
+            &consecutive_trio_plan);
       }
-      if (at_least_one_sample_analyzable) {
-        ++event_count_;
-        output_file_ << buffer_ss.str() << "\n";
+      Utilities::Require(!pedigree_.IsLoaded() || pedigree_.IsResolved(),
+          "Analyzer error: the VCF file has no #CHROM line to match the "
+          "PED file with.");
+
+      // the samples are parsed once, whichever configurations count them
+      ReadSamples(record, event, format_plan, *trio_plan, &samples,
+          &stage_timer);
+      // the first 8 columns go unchanged to the output file
+      Span fixed_columns(record.GetLine().begin(),
+          record.GetColumn(kInfo).end());
+      if (record_cache != NULL) {
+        stage_timer.Switch(kOutputStage);
+        cached_record.fixed_columns = fixed_columns;
+        cached_record.reference = refString;
+        cached_record.alt = altString;
+        cached_record.number_of_samples = record.GetNumberOfSamples();
+        cached_record.results = samples.results;
+        record_cache->Add(cached_record);
       }
+      AnalyzeRecord(fixed_columns, event, *trio_plan, should_analyze_variant,
+          samples, &calls, statistics, configuration_statistics,
+          &output_batch, &stage_timer);
+    }
+    for (size_t index = 0; index < region_indices.size(); ++index) {
+      statistics->AddToRegion(region_indices[index], counts_before);
     }
   } // loop over lines
-  ShowResults();
+  stage_timer.Switch(kOutputStage);
+  output_writer_.Submit(output_stream_index, &output_batch);
+  output_writer_.CloseStream(output_stream_index);
+}
+
+/** Analyzes one range of the input file on a thread of its own. **/
+void Analyzer::AnalyzeRange(const Span& range, Statistics* statistics,
+    std::vector<Statistics>* configuration_statistics,
+    int output_stream_index, ThreadCounters* counters) {
+  VcfScanner scanner(range);
+  AnalyzeLines(&scanner, statistics, configuration_statistics,
+      output_stream_index, counters);
+}
+
+/** Reads the extra configurations: one per line, a name followed by the
+ * type, size and confidence arguments as on the command line (for example
+ * 'large_deletions del sizegt50 c0.7'). The name is used in the names of the
+ * files with the results of the configuration. **/
+void Analyzer::ReadConfigurations(
+    const std::string& name_of_configurations_file) {
+  std::ifstream configurations_file(name_of_configurations_file.c_str());
+  Utilities::Require(configurations_file.good(), "Analyzer error: cannot "
+      "open configurations file '" + name_of_configurations_file + "'.");
+  std::set<std::string> names;
+  // the main analysis writes the files with suffix '1'
+  names.insert("1");
+  std::string line;
+  while (std::getline(configurations_file, line)) {
+    std::stringstream fields(line);
+    Configuration configuration;
+    if (!(fields >> configuration.name) || configuration.name[0] == '#') {
+      continue;
+    }
+    for (size_t index = 0; index < configuration.name.size(); ++index) {
+      char ch = configuration.name[index];
+      Utilities::Require(isalnum(ch) || ch == '_' || ch == '-' || ch == '.',
+          "Analyzer error: invalid configuration name '" +
+          configuration.name + "'.");
+    }
+    Utilities::Require(names.insert(configuration.name).second,
+        "Analyzer error: configuration name '" + configuration.name +
+        "' is used twice.");
+    std::vector<std::string> arguments;
+    std::string argument;
+    std::cout << "\nConfiguration " << configuration.name << ":";
+    while (fields >> argument) {
+      arguments.push_back(argument);
+      std::cout << " " << argument;
+    }
+    std::cout << "\n";
+    for (size_t index = 0; index < arguments.size(); ++index) {
+      configuration.settings.AddFilter(arguments[index].c_str());
+    }
+    configuration.settings.Complete();
+    configurations_.push_back(configuration);
+  }
+}
+
+/** Handles a header line: the #CHROM line names the samples, which the
+ * pedigree (if any) needs. **/
+void Analyzer::ReadHeaderLine(const Span& line) {
+  const char* CHROM_LINE_START = "#CHROM";
+  if (pedigree_.IsLoaded() && !pedigree_.IsResolved() &&
+      line.size() >= strlen(CHROM_LINE_START) &&
+      memcmp(line.begin(), CHROM_LINE_START, strlen(CHROM_LINE_START)) == 0) {
+    pedigree_.ResolveSampleNames(line);
+  }
+}
+
+/** Copies the header lines of the input file to 'output_batch'. **/
+void Analyzer::CopyHeader(std::string* output_batch) {
+  Span line;
+  while (m_inputFile.NextLine(&line) && !line.empty() && line[0] == '#') {
+    ReadHeaderLine(line);
+    output_batch->append(line.begin(), line.size());
+    output_batch->push_back('\n');
+  }
+}
+
+/** Takes over the counts of the checkpoint to resume from, and cuts the
+ * output file back to what had been written at that checkpoint. The
+ * analysis then continues at the line after the checkpoint. **/
+void Analyzer::ContinueFromCheckpoint() {
+  Checkpoint checkpoint;
+  checkpoint.Read(settings_->GetNameOfResumeFile());
+  Utilities::Require(checkpoint.size_of_input_file > 0 &&
+      checkpoint.size_of_input_file ==
+      Checkpoint::GetSizeOfFile(name_of_input_file_),
+      "Analyzer error: the checkpoint is not of this input file, or the "
+      "file has changed since.");
+  Utilities::Require(checkpoint.configuration_statistics.size() ==
+      configurations_.size(), "Analyzer error: the checkpoint was made "
+      "with a different number of configurations.");
+  statistics_ = checkpoint.statistics;
+  configuration_statistics_ = checkpoint.configuration_statistics;
+  output_writer_.ContinueAt(checkpoint.output_size);
+  resume_offset_ = checkpoint.input_offset;
+  std::cout << "\nContinuing from the checkpoint at byte " <<
+      resume_offset_ << " of the input\n";
+}
+
+/** Writes a checkpoint: the counts in 'statistics' and
+ * 'configuration_statistics' are those of all lines before 'input_offset'.
+ * The output batch is written out first, so that the output file holds
+ * exactly the output of those lines. **/
+void Analyzer::WriteCheckpoint(unsigned long long input_offset,
+    const Statistics& statistics,
+    const std::vector<Statistics>& configuration_statistics,
+    int output_stream_index, std::string* output_batch) {
+  Checkpoint checkpoint;
+  checkpoint.name_of_input_file = name_of_input_file_;
+  checkpoint.size_of_input_file =
+      Checkpoint::GetSizeOfFile(name_of_input_file_);
+  checkpoint.input_offset = input_offset;
+  checkpoint.output_size = output_writer_.Flush(output_stream_index,
+      output_batch);
+  checkpoint.statistics = statistics;
+  checkpoint.configuration_statistics = configuration_statistics;
+  checkpoint.Write(settings_->GetNameOfCheckpointFile());
+  std::cout << "\nCheckpoint: " << input_offset << " bytes of the input, " <<
+      statistics.event_count << " events analyzed" << std::endl;
+}
+
+/** Analyzes only the chunks of the (BGZF-compressed) input file that can
+ * hold records in the regions according to the index. The header is still
+ * copied to the output. Returns false (analyzing nothing) if the input file
+ * has no usable index. **/
+bool Analyzer::AnalyzeIndexedRegions() {
+  TabixIndex index(name_of_input_file_);
+  if (!index.IsLoaded() || !m_inputFile.IsCompressed()) {
+    std::cout << "\nWarning: no usable tabix or CSI index for " <<
+        name_of_input_file_ << "; reading the whole file to find the " <<
+        "records in the regions.\n";
+    return false;
+  }
+  std::vector<BgzfReader::Chunk> chunks;
+  for (int region_index = 0; region_index < regions_.GetNumberOfRegions();
+      ++region_index) {
+    index.AddChunks(regions_.GetRegion(region_index), &chunks);
+  }
+  TabixIndex::MergeChunks(&chunks);
+  std::cout << "\nReading " << chunks.size() << " chunk(s) of the input " <<
+      "file using index " << index.GetNameOfIndexFile() << "\n";
+
+  output_writer_.Start(1, instrumentation_.AddThread("output writer"));
+  std::string header;
+  CopyHeader(&header);
+  if (resume_offset_ == 0) {
+    output_writer_.Submit(0, &header);
+  }
+  VcfScanner scanner(name_of_input_file_, chunks,
+      settings_->GetNumberOfThreads());
+  scanner.SkipTo(resume_offset_);
+  AnalyzeLines(&scanner, &statistics_, &configuration_statistics_, 0,
+      instrumentation_.AddThread("analysis"));
+  output_writer_.Finish();
+  return true;
+}
+
+/** Splits the (memory-mapped) input file into ranges that are analyzed in
+ * parallel; the partial statistics are merged afterwards and the output
+ * writer writes the output of the ranges in the order of the file, so the
+ * result is the same as that of a single thread. **/
+void Analyzer::AnalyzeRanges() {
+  // the threads share the pedigree, so it has to be matched to the samples
+  // before they start
+  VcfScanner header_scanner(m_inputFile.SplitIntoRanges(1)[0]);
+  Span line;
+  while (header_scanner.NextLine(&line) && !line.empty() && line[0] == '#') {
+    ReadHeaderLine(line);
+  }
+
+  std::vector<Span> ranges =
+      m_inputFile.SplitIntoRanges(settings_->GetNumberOfThreads());
+  std::vector<Statistics> partial_statistics(ranges.size());
+  std::vector<std::vector<Statistics> > partial_configuration_statistics(
+      ranges.size(), std::vector<Statistics>(configurations_.size()));
+  std::vector<std::thread> threads;
+  output_writer_.Start(ranges.size(),
+      instrumentation_.AddThread("output writer"));
+  for (size_t range_index = 0; range_index < ranges.size(); ++range_index) {
+    std::stringstream name_of_thread;
+    name_of_thread << "analysis " << range_index + 1;
+    threads.push_back(std::thread(&Analyzer::AnalyzeRange, this,
+        ranges[range_index], &partial_statistics[range_index],
+        &partial_configuration_statistics[range_index], range_index,
+        instrumentation_.AddThread(name_of_thread.str())));
+  }
+  for (size_t range_index = 0; range_index < ranges.size(); ++range_index) {
+    threads[range_index].join();
+    statistics_.Merge(partial_statistics[range_index]);
+    for (size_t index = 0; index < configurations_.size(); ++index) {
+      configuration_statistics_[index].Merge(
+          partial_configuration_statistics[range_index][index]);
+    }
+  }
+  output_writer_.Finish();
+}
+
+/** Reads the input file, analyzes the trios found therein for Mendelian
+ * violations. With more than one thread, ranges of the file are analyzed in
+ * parallel. If the analysis is restricted to regions, an index of the input
+ * file is used to read only the parts of the file that matter. **/
+void Analyzer::AnalyzeInput() {
+  // checkpoints are made by a single analysis thread
+  bool is_checkpointing = !settings_->GetNameOfCheckpointFile().empty() ||
+      !settings_->GetNameOfResumeFile().empty();
+  if (is_checkpointing && settings_->GetNumberOfThreads() > 1 &&
+      m_inputFile.IsMapped()) {
+    std::cout << "\nNote: with checkpoints, the file is analyzed by a " <<
+        "single thread.\n";
+  }
+  if (regions_.IsEmpty() || !AnalyzeIndexedRegions()) {
+    if (settings_->GetNumberOfThreads() == 1 || !m_inputFile.IsMapped() ||
+        is_checkpointing) {
+      output_writer_.Start(1, instrumentation_.AddThread("output writer"));
+      if (resume_offset_ > 0) {
+        // the header lines have been written already, but the pedigree
+        // needs them
+        VcfScanner header_scanner(name_of_input_file_);
+        Span line;
+        while (header_scanner.NextLine(&line) && !line.empty() &&
+            line[0] == '#') {
+          ReadHeaderLine(line);
+        }
+        m_inputFile.SkipTo(resume_offset_);
+      }
+      AnalyzeLines(&m_inputFile, &statistics_, &configuration_statistics_, 0,
+          instrumentation_.AddThread("analysis"));
+      output_writer_.Finish();
+    }
+    else {
+      AnalyzeRanges();
+    }
+  }
+}
+
+/** Ends the first pass of a calibration: the confidences are calibrated on
+ * the qualities counted, and the counts start over for the second pass. **/
+void Analyzer::EndCalibrationPass() {
+  call_confidence_estimator_.Calibrate(statistics_);
+  std::cout << "\nCalibrated the confidences on " <<
+      statistics_.mendelian_correct << " correct and " <<
+      statistics_.mendelian_error << " erroneous trios; analyzing again\n";
+  is_calibration_pass_ = false;
+  // the second pass may not see the records that no filter let through
+  int unstored_allele_records = statistics_.unstored_allele_records;
+  statistics_ = Statistics();
+  statistics_.unstored_allele_records = unstored_allele_records;
+  configuration_statistics_.assign(configurations_.size(), Statistics());
 }
 
+/** Analyzes the input file, or its cache file if there is one. With
+ * 'calibrate', the confidences are not read from quality files but
+ * calibrated on the input itself: a first pass counts the qualities of all
+ * calls, and keeps the parsed records in a cache; the second pass analyzes
+ * the cached records with the confidences that those qualities give. If
+ * asked for, the timings and counts of the run are written to a report. **/
+void Analyzer::analyze() {
+  instrumentation_.Start();
+  if (!settings_->GetNameOfResumeFile().empty()) {
+    ContinueFromCheckpoint();
+  }
+  bool is_using_cache = !settings_->GetNameOfCacheFile().empty();
+  if (settings_->IsCalibrating() || is_using_cache) {
+    Utilities::Require(settings_->GetNameOfCheckpointFile().empty() &&
+        settings_->GetNameOfResumeFile().empty(), "Analyzer error: "
+        "checkpoints cannot be combined with 'calibrate' or 'cache'.");
+  }
+  if (settings_->IsCalibrating()) {
+    call_confidence_estimator_.Calibrate(Statistics());
+    is_calibration_pass_ = true;
+  }
+  if (is_using_cache) {
+    AnalyzeGenotypeCache();
+  }
+  else if (is_calibration_pass_) {
+    // one cache per output stream, of which there are at most as many as
+    // threads
+    for (int index = 0;
+        index < std::max(1, settings_->GetNumberOfThreads()); ++index) {
+      record_caches_.push_back(new RecordCache());
+    }
+    AnalyzeInput();
+    EndCalibrationPass();
+    AnalyzeRecordCaches();
+  }
+  else {
+    AnalyzeInput();
+  }
+  instrumentation_.Finish();
+  ShowResults();
+}
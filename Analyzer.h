@@ -15,16 +15,31 @@
 #define ANALYZER_H_
 
 #include <fstream>
+#include <iostream>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "CallConfidenceEstimator.h"
+#include "ConfidenceSweep.h"
 #include "Event.h"
+#include "FormatPlan.h"
 #include "Genotype.h"
+#include "GenotypeCache.h"
 #include "GenotypingResults.h"
+#include "Instrumentation.h"
+#include "OutputWriter.h"
+#include "Pedigree.h"
 #include "Quality.h"
+#include "RecordCache.h"
+#include "RecordClassifier.h"
+#include "RegionSet.h"
 #include "Settings.h"
+#include "Statistics.h"
+#include "Span.h"
+#include "TabixIndex.h"
+#include "VcfRecord.h"
+#include "VcfScanner.h"
 
 
 class Analyzer {
@@ -34,45 +49,87 @@ public:
   virtual ~Analyzer();
 
 private:
-  bool AnalyzeSamples(std::stringstream& ss, const Event& event,
-      const std::string& line, bool* all_genotyped, std::stringstream& buffer_ss);
-  bool ClassifyTrio(const std::vector<GenotypingResults>& genotyping_results,
-      const Event& event, const std::string& line, bool* is_genotypable);
-  void ScoreAsCorrect(const std::vector<GenotypingResults>& genotyping_results,
-      const Event& event, bool is_correct, const std::string& line);
+  // a set of extra filters (type, size and confidence) whose counts are
+  // gathered in the same pass over the input file as the main analysis
+  struct Configuration {
+    std::string name;
+    Settings settings;
+  };
 
+  template <class Cache>
+  void AnalyzeCachedRecords(Cache* cache, std::string* output_batch,
+      StageTimer* stage_timer);
+  void AnalyzeGenotypeCache();
+  bool AnalyzeIndexedRegions();
+  void AnalyzeInput();
+  void AnalyzeLines(VcfScanner* scanner, Statistics* statistics,
+      std::vector<Statistics>* configuration_statistics,
+      int output_stream_index, ThreadCounters* counters);
+  void AnalyzeRange(const Span& range, Statistics* statistics,
+      std::vector<Statistics>* configuration_statistics,
+      int output_stream_index, ThreadCounters* counters);
+  void AnalyzeRanges();
+  void AnalyzeRecordCaches();
+  void AnalyzeRecord(const Span& fixed_columns, const Event& event,
+      const TrioPlan& trio_plan, bool should_analyze_variant,
+      const ParsedSamples& samples, std::vector<signed char>* calls,
+      Statistics* statistics,
+      std::vector<Statistics>* configuration_statistics,
+      std::string* output_batch, StageTimer* stage_timer) const;
+
+  void ContinueFromCheckpoint();
+  void CopyHeader(std::string* output_batch);
+  void EndCalibrationPass();
+  void EstimateConfidences(const Event& event, ParsedSamples* samples,
+      StageTimer* stage_timer) const;
+  void FindRegions(const VcfRecord& record, const Span& reference,
+      std::vector<int>* region_indices) const;
+  bool IsInAConfiguration(const Event& event) const;
+  void ReadConfigurations(const std::string& name_of_configurations_file);
+  void ReadHeaderLine(const Span& line);
+  void RequireTrioSamples(const TrioPlan& trio_plan,
+      int number_of_samples) const;
+  void ReadSamples(const VcfRecord& record, const Event& event,
+      const FormatPlan& format_plan, const TrioPlan& trio_plan,
+      ParsedSamples* samples, StageTimer* stage_timer) const;
+  void OutputConfidenceSweep() const;
+  void OutputConfigurationResults() const;
+  void OutputRegionResults() const;
   void ShowMendelianErrorMap() const;
   void ShowResults() const;
-  void UpdateMendelianErrorMap(const Genotype& firstParentGenotype,
-      const Genotype& secondParentGenotype, const Genotype& childGenotype);
   void OutputBins() const;
+  void WriteBins(const Statistics& statistics,
+      const std::string& suffix) const;
+  void WriteCheckpoint(unsigned long long input_offset,
+      const Statistics& statistics,
+      const std::vector<Statistics>& configuration_statistics,
+      int output_stream_index, std::string* output_batch);
+  void WriteGenotypeCache(const std::string& name_of_cache_file,
+      const InputFileIdentity& input_file, ThreadCounters* counters);
 
-
-  static const int NUM_VAF_BINS = 40;
-  Quality vaf_qualities_[NUM_VAF_BINS];
-
-  static const int COVERAGE_RESOLUTION = 5;
-  static const int MAX_SUPPORT = 200;
-  Quality coverage_qualities_[1 + MAX_SUPPORT / COVERAGE_RESOLUTION];
-
-  std::map<EventType, Quality> eventtype_qualities_;
+  // with checkpoints, the clock is looked at once per this many lines
+  static const int LINES_PER_CLOCK_CHECK = 4096;
 
   CallConfidenceEstimator call_confidence_estimator_;
-  std::ofstream output_file_;
-  int unknown_count_;
-  int m_mendelianCorrect;
-  int m_mendelianError;
-  std::ifstream m_inputFile;
-  int all_genotyped_;
-  int all_homref_;
-  int event_count_;
-  int trio_count_[4] = {0,0,0,0};
-  int unknown_calls_;
-  int homref_calls_;
-  int variant_calls_;
+  OutputWriter output_writer_;
+  Instrumentation instrumentation_;
+  VcfScanner m_inputFile;
+  std::string name_of_input_file_;
 
   const Settings* settings_;
-  std::map<std::string, int> me_map_;
+  RecordClassifier classifier_;
+  RegionSet regions_;
+  Pedigree pedigree_;
+  Statistics statistics_;
+  std::vector<Configuration> configurations_;
+  std::vector<Statistics> configuration_statistics_;
+  // the offset in the input at which an interrupted analysis continues
+  unsigned long long resume_offset_;
+  // in the first pass of a calibration, only the qualities are counted;
+  // without a cache file, each output stream keeps its records in its own
+  // cache for the second pass
+  bool is_calibration_pass_;
+  std::vector<RecordCache*> record_caches_;
 };
 
 #endif /* ANALYZER_H_ */
@@ -0,0 +1,385 @@
+/*
+ * BgzfReader.cpp
+ *
+ * Decompresses gzip-compressed input. BGZF files (the blocked gzip format of
+ * .vcf.gz files made by bgzip) consist of many small, independent gzip
+ * blocks; batches of those blocks are decompressed by a pool of threads
+ * while earlier batches are being analyzed. Other gzip files are
+ * decompressed as a single stream. A BGZF file can also be read partially,
+ * as a list of chunks (ranges of virtual offsets, as found in a tabix index).
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "BgzfReader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <unistd.h>
+
+#include "Utilities.h"
+
+namespace {
+
+const size_t BGZF_HEADER_SIZE = 18;
+const size_t GZIP_FOOTER_SIZE = 8;
+const int VIRTUAL_OFFSET_SHIFT = 16;
+const unsigned long long OFFSET_IN_BLOCK_MASK = 0xffff;
+
+/** Reads a little-endian unsigned integer of 'size' bytes. **/
+unsigned int GetLittleEndian(const char* bytes, int size) {
+  unsigned int value = 0;
+  for (int index = size - 1; index >= 0; --index) {
+    value = (value << 8) | static_cast<unsigned char>(bytes[index]);
+  }
+  return value;
+}
+
+/** Is this the header of a BGZF block: a gzip header with one extra
+ * subfield, 'BC', that holds the size of the block? **/
+bool IsBgzfHeader(const char* header) {
+  return BgzfReader::IsGzipMagic(header, BGZF_HEADER_SIZE) &&
+      header[2] == 8 && (header[3] & 4) != 0 &&
+      GetLittleEndian(header + 10, 2) == 6 &&
+      header[12] == 'B' && header[13] == 'C' &&
+      GetLittleEndian(header + 14, 2) == 2;
+}
+
+} // namespace
+
+/** Constructor. 'bytes_already_read' are the bytes that the caller already
+ * read from the file (to recognize it as gzip). BGZF input gets
+ * 'number_of_threads' decompression threads. **/
+BgzfReader::BgzfReader(int file_descriptor,
+    const std::string& bytes_already_read, int number_of_threads) :
+    file_descriptor_(file_descriptor),
+    bytes_already_read_(bytes_already_read), bytes_already_read_position_(0),
+    is_bgzf_(false), is_end_of_file_(false), compressed_position_(0),
+    current_chunk_(0), current_batch_(0), is_stopping_(false),
+    is_in_gzip_member_(false) {
+  if (bytes_already_read_.size() < BGZF_HEADER_SIZE) {
+    char header[BGZF_HEADER_SIZE];
+    size_t bytes_read = Utilities::ReadFully(file_descriptor_, header,
+        BGZF_HEADER_SIZE - bytes_already_read_.size());
+    bytes_already_read_.append(header, bytes_read);
+  }
+  is_bgzf_ = bytes_already_read_.size() >= BGZF_HEADER_SIZE &&
+      IsBgzfHeader(bytes_already_read_.data());
+
+  if (is_bgzf_) {
+    StartThreads(number_of_threads);
+  }
+  else {
+    memset(&stream_, 0, sizeof(stream_));
+    // 15 + 16: a window of up to 32 kB, gzip headers only
+    Utilities::Require(inflateInit2(&stream_, 15 + 16) == Z_OK,
+        "BgzfReader error: cannot initialize zlib.");
+    stream_input_.resize(STREAM_BUFFER_SIZE);
+  }
+}
+
+/** Constructor for reading only the given chunks of a BGZF file, in the
+ * given order. Chunks should not overlap. **/
+BgzfReader::BgzfReader(int file_descriptor, const std::vector<Chunk>& chunks,
+    int number_of_threads) :
+    file_descriptor_(file_descriptor), bytes_already_read_position_(0),
+    is_bgzf_(true), is_end_of_file_(false), compressed_position_(0),
+    chunks_(chunks), current_chunk_(0), current_batch_(0),
+    is_stopping_(false), is_in_gzip_member_(false) {
+  if (!chunks_.empty()) {
+    compressed_position_ = chunks_[0].begin >> VIRTUAL_OFFSET_SHIFT;
+  }
+  StartThreads(number_of_threads);
+}
+
+/** Starts the decompression threads and lets them decompress the first
+ * batches. **/
+void BgzfReader::StartThreads(int number_of_threads) {
+  batches_.resize(2 * number_of_threads + 1);
+  for (int thread_index = 0; thread_index < number_of_threads;
+      ++thread_index) {
+    threads_.push_back(std::thread(&BgzfReader::DecompressBatches, this));
+  }
+  for (size_t batch_index = 0; batch_index < batches_.size(); ++batch_index) {
+    FillBatch(batch_index);
+  }
+}
+
+/** Destructor; stops the decompression threads. **/
+BgzfReader::~BgzfReader() {
+  if (is_bgzf_) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      is_stopping_ = true;
+      job_added_.notify_all();
+    }
+    for (size_t thread_index = 0; thread_index < threads_.size();
+        ++thread_index) {
+      threads_[thread_index].join();
+    }
+  }
+  else {
+    inflateEnd(&stream_);
+  }
+}
+
+/** Do these bytes start like a gzip file? **/
+bool BgzfReader::IsGzipMagic(const char* bytes, size_t size) {
+  return size >= 2 && static_cast<unsigned char>(bytes[0]) == 0x1f &&
+      static_cast<unsigned char>(bytes[1]) == 0x8b;
+}
+
+/** Puts up to 'size' decompressed bytes into 'buffer'. Returns the number of
+ * bytes, which is only 0 at the end of the file. **/
+size_t BgzfReader::Read(char* buffer, size_t size) {
+  if (!is_bgzf_) {
+    return ReadFromStream(buffer, size);
+  }
+  size_t bytes_copied = 0;
+  while (bytes_copied < size && !is_end_of_file_) {
+    Batch& batch = batches_[current_batch_];
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (batch.state != kDecompressed) {
+        batch_decompressed_.wait(lock);
+      }
+    }
+    if (batch.is_end_of_file) {
+      is_end_of_file_ = true;
+      break;
+    }
+    size_t bytes_to_copy = std::min(size - bytes_copied,
+        batch.decompressed.size() - batch.read_position);
+    if (bytes_to_copy > 0) {
+      memcpy(buffer + bytes_copied, &batch.decompressed[batch.read_position],
+          bytes_to_copy);
+    }
+    batch.read_position += bytes_to_copy;
+    bytes_copied += bytes_to_copy;
+    if (batch.read_position == batch.decompressed.size()) {
+      // the batch is used up; its place goes to the next batch of the file
+      FillBatch(current_batch_);
+      current_batch_ = (current_batch_ + 1) % batches_.size();
+    }
+  }
+  return bytes_copied;
+}
+
+/** Appends the next BGZF block of the input (or of the chunks) to
+ * 'compressed' and describes it in 'block'. Returns false at the end of the
+ * file or of the last chunk. **/
+bool BgzfReader::ReadBlock(std::vector<char>* compressed, Block* block) {
+  block->start = compressed->size();
+  block->keep_from = 0;
+  block->keep_until = std::string::npos;
+  if (!chunks_.empty()) {
+    // a chunk ends before the block that holds its end, unless the end lies
+    // inside that block
+    while (current_chunk_ < chunks_.size()) {
+      unsigned long long end = chunks_[current_chunk_].end;
+      unsigned long long end_block = end >> VIRTUAL_OFFSET_SHIFT;
+      if (compressed_position_ < end_block ||
+          (compressed_position_ == end_block &&
+          (end & OFFSET_IN_BLOCK_MASK) != 0)) {
+        break;
+      }
+      ++current_chunk_;
+      if (current_chunk_ < chunks_.size()) {
+        compressed_position_ =
+            chunks_[current_chunk_].begin >> VIRTUAL_OFFSET_SHIFT;
+      }
+    }
+    if (current_chunk_ == chunks_.size()) {
+      return false;
+    }
+    const Chunk& chunk = chunks_[current_chunk_];
+    if (compressed_position_ == chunk.begin >> VIRTUAL_OFFSET_SHIFT) {
+      block->keep_from = chunk.begin & OFFSET_IN_BLOCK_MASK;
+    }
+    if (compressed_position_ == chunk.end >> VIRTUAL_OFFSET_SHIFT) {
+      block->keep_until = chunk.end & OFFSET_IN_BLOCK_MASK;
+    }
+  }
+
+  char header[BGZF_HEADER_SIZE];
+  size_t bytes_read = ReadCompressed(header, BGZF_HEADER_SIZE);
+  if (bytes_read == 0) {
+    return false;
+  }
+  Utilities::Require(bytes_read == BGZF_HEADER_SIZE && IsBgzfHeader(header),
+      "BgzfReader error: the input is not a valid BGZF file.");
+  size_t block_size = GetLittleEndian(header + 16, 2) + 1;
+  Utilities::Require(block_size >= BGZF_HEADER_SIZE + GZIP_FOOTER_SIZE,
+      "BgzfReader error: invalid BGZF block size.");
+  compressed->resize(block->start + block_size);
+  memcpy(&(*compressed)[block->start], header, BGZF_HEADER_SIZE);
+  size_t rest_of_block = block_size - BGZF_HEADER_SIZE;
+  Utilities::Require(ReadCompressed(&(*compressed)[block->start +
+      BGZF_HEADER_SIZE], rest_of_block) == rest_of_block,
+      "BgzfReader error: the input file is truncated.");
+  return true;
+}
+
+/** Reads the compressed blocks of the next batch into the batch with index
+ * 'batch_index' and queues it for decompression. **/
+void BgzfReader::FillBatch(int batch_index) {
+  Batch& batch = batches_[batch_index];
+  batch.compressed.clear();
+  batch.blocks.clear();
+  batch.read_position = 0;
+  Block block;
+  while (batch.blocks.size() < static_cast<size_t>(BLOCKS_PER_BATCH) &&
+      ReadBlock(&batch.compressed, &block)) {
+    batch.blocks.push_back(block);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (batch.blocks.empty()) {
+    batch.decompressed.clear();
+    batch.is_end_of_file = true;
+    batch.state = kDecompressed;
+    batch_decompressed_.notify_all();
+  }
+  else {
+    batch.state = kQueued;
+    jobs_.push_back(batch_index);
+    job_added_.notify_one();
+  }
+}
+
+/** The decompression threads: take queued batches and decompress them. **/
+void BgzfReader::DecompressBatches() {
+  while (true) {
+    int batch_index;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (jobs_.empty() && !is_stopping_) {
+        job_added_.wait(lock);
+      }
+      if (is_stopping_) {
+        return;
+      }
+      batch_index = jobs_.front();
+      jobs_.pop_front();
+    }
+    DecompressBatch(&batches_[batch_index]);
+    std::lock_guard<std::mutex> lock(mutex_);
+    batches_[batch_index].state = kDecompressed;
+    batch_decompressed_.notify_all();
+  }
+}
+
+/** Inflates all blocks of a batch, checking the size and CRC of each, and
+ * keeps the wanted part of each. **/
+void BgzfReader::DecompressBatch(Batch* batch) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // negative window bits: raw deflate data, the gzip header is skipped here
+  Utilities::Require(inflateInit2(&stream, -15) == Z_OK,
+      "BgzfReader error: cannot initialize zlib.");
+  batch->decompressed.clear();
+  for (size_t block_index = 0; block_index < batch->blocks.size();
+      ++block_index) {
+    const Block& block_data = batch->blocks[block_index];
+    size_t end_of_block = (block_index + 1 < batch->blocks.size()) ?
+        batch->blocks[block_index + 1].start : batch->compressed.size();
+    const char* block = &batch->compressed[block_data.start];
+    size_t block_size = end_of_block - block_data.start;
+    unsigned int expected_crc = GetLittleEndian(block + block_size - 8, 4);
+    unsigned int uncompressed_size = GetLittleEndian(block + block_size - 4,
+        4);
+
+    size_t start_of_output = batch->decompressed.size();
+    batch->decompressed.resize(start_of_output + uncompressed_size);
+    char* output = batch->decompressed.empty() ?
+        NULL : &batch->decompressed[start_of_output];
+    inflateReset(&stream);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block +
+        BGZF_HEADER_SIZE));
+    stream.avail_in = block_size - BGZF_HEADER_SIZE - GZIP_FOOTER_SIZE;
+    stream.next_out = reinterpret_cast<Bytef*>(output);
+    stream.avail_out = uncompressed_size;
+    int result = inflate(&stream, Z_FINISH);
+    Utilities::Require(result == Z_STREAM_END && stream.avail_out == 0,
+        "BgzfReader error: corrupt BGZF block.");
+    unsigned int crc = crc32(0L, reinterpret_cast<const Bytef*>(output),
+        uncompressed_size);
+    Utilities::Require(crc == expected_crc,
+        "BgzfReader error: CRC mismatch in BGZF block.");
+
+    size_t keep_until = std::min<size_t>(block_data.keep_until,
+        uncompressed_size);
+    size_t keep_from = std::min(block_data.keep_from, keep_until);
+    if (keep_from > 0) {
+      memmove(output, output + keep_from, keep_until - keep_from);
+    }
+    batch->decompressed.resize(start_of_output + keep_until - keep_from);
+  }
+  inflateEnd(&stream);
+}
+
+/** Reads compressed bytes; first those the caller had already read. When
+ * reading chunks, reads at compressed_position_ instead. **/
+size_t BgzfReader::ReadCompressed(char* buffer, size_t size) {
+  if (!chunks_.empty()) {
+    size_t total_bytes_read = 0;
+    while (total_bytes_read < size) {
+      ssize_t bytes_read = pread(file_descriptor_, buffer + total_bytes_read,
+          size - total_bytes_read, compressed_position_);
+      if (bytes_read < 0 && errno == EINTR) {
+        continue;
+      }
+      if (bytes_read <= 0) {
+        break;
+      }
+      total_bytes_read += bytes_read;
+      compressed_position_ += bytes_read;
+    }
+    return total_bytes_read;
+  }
+  size_t bytes_copied = std::min(size,
+      bytes_already_read_.size() - bytes_already_read_position_);
+  memcpy(buffer, bytes_already_read_.data() + bytes_already_read_position_,
+      bytes_copied);
+  bytes_already_read_position_ += bytes_copied;
+  size_t bytes_read = bytes_copied + Utilities::ReadFully(file_descriptor_,
+      buffer + bytes_copied, size - bytes_copied);
+  compressed_position_ += bytes_read;
+  return bytes_read;
+}
+
+/** Decompresses ordinary gzip input (possibly several concatenated gzip
+ * members) on the calling thread. Aborts if the input ends inside a
+ * member. **/
+size_t BgzfReader::ReadFromStream(char* buffer, size_t size) {
+  stream_.next_out = reinterpret_cast<Bytef*>(buffer);
+  stream_.avail_out = size;
+  while (stream_.avail_out > 0 && !is_end_of_file_) {
+    if (stream_.avail_in == 0) {
+      size_t bytes_read = ReadCompressed(&stream_input_[0],
+          stream_input_.size());
+      if (bytes_read == 0) {
+        Utilities::Require(!is_in_gzip_member_,
+            "BgzfReader error: the input file is truncated.");
+        is_end_of_file_ = true;
+        break;
+      }
+      stream_.next_in = reinterpret_cast<Bytef*>(&stream_input_[0]);
+      stream_.avail_in = bytes_read;
+    }
+    is_in_gzip_member_ = true;
+    int result = inflate(&stream_, Z_NO_FLUSH);
+    if (result == Z_STREAM_END) {
+      // another gzip member may follow
+      inflateReset(&stream_);
+      is_in_gzip_member_ = false;
+    }
+    else {
+      Utilities::Require(result == Z_OK || result == Z_BUF_ERROR,
+          "BgzfReader error: corrupt gzip input.");
+    }
+  }
+  return size - stream_.avail_out;
+}
@@ -0,0 +1,103 @@
+/*
+ * BgzfReader.h
+ *
+ * Decompresses gzip-compressed input. BGZF files (the blocked gzip format of
+ * .vcf.gz files made by bgzip) consist of many small, independent gzip
+ * blocks; batches of those blocks are decompressed by a pool of threads
+ * while earlier batches are being analyzed. Other gzip files are
+ * decompressed as a single stream. A BGZF file can also be read partially,
+ * as a list of chunks (ranges of virtual offsets, as found in a tabix index).
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef BGZFREADER_H_
+#define BGZFREADER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+class BgzfReader {
+public:
+  // a range of a BGZF file; a virtual offset is the offset of a block in the
+  // compressed file times 2^16 plus an offset in the decompressed block
+  struct Chunk {
+    unsigned long long begin;
+    unsigned long long end;
+  };
+
+  BgzfReader(int file_descriptor, const std::string& bytes_already_read,
+      int number_of_threads);
+  BgzfReader(int file_descriptor, const std::vector<Chunk>& chunks,
+      int number_of_threads);
+  virtual ~BgzfReader();
+
+  static bool IsGzipMagic(const char* bytes, size_t size);
+  size_t Read(char* buffer, size_t size);
+
+private:
+  enum BatchState { kEmpty, kQueued, kDecompressed };
+
+  // a block within the compressed data of a batch, and which part of its
+  // decompressed text is wanted
+  struct Block {
+    size_t start;
+    size_t keep_from;
+    size_t keep_until;
+  };
+
+  // a series of BGZF blocks, decompressed as one job
+  struct Batch {
+    Batch() : state(kEmpty), read_position(0), is_end_of_file(false) {}
+    BatchState state;
+    std::vector<char> compressed;
+    std::vector<Block> blocks;
+    std::vector<char> decompressed;
+    size_t read_position;
+    bool is_end_of_file;
+  };
+
+  static void DecompressBatch(Batch* batch);
+  void DecompressBatches();
+  void FillBatch(int batch_index);
+  size_t ReadCompressed(char* buffer, size_t size);
+  size_t ReadFromStream(char* buffer, size_t size);
+  bool ReadBlock(std::vector<char>* compressed, Block* block);
+  void StartThreads(int number_of_threads);
+
+  static const int BLOCKS_PER_BATCH = 64;
+  static const size_t STREAM_BUFFER_SIZE = 1 << 20;
+
+  int file_descriptor_;
+  std::string bytes_already_read_;
+  size_t bytes_already_read_position_;
+  bool is_bgzf_;
+  bool is_end_of_file_;
+  unsigned long long compressed_position_;
+
+  // for BGZF input; if there are chunks, only those are read
+  std::vector<Chunk> chunks_;
+  size_t current_chunk_;
+  std::vector<Batch> batches_;
+  int current_batch_;
+  std::deque<int> jobs_;
+  bool is_stopping_;
+  std::mutex mutex_;
+  std::condition_variable job_added_;
+  std::condition_variable batch_decompressed_;
+  std::vector<std::thread> threads_;
+
+  // for other gzip input
+  z_stream stream_;
+  std::vector<char> stream_input_;
+  // has a gzip member been started but not finished?
+  bool is_in_gzip_member_;
+};
+
+#endif /* BGZFREADER_H_ */
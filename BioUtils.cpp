@@ -11,8 +11,6 @@
 
 #include "BioUtils.h"
 
-#include <sstream>
-
 #include "Utilities.h"
 
 namespace BioUtils {
@@ -89,21 +87,145 @@ bool canBeMendelianCorrect(const Genotype& firstParent,
   return false;
 }
 
-/** Returns basic data about this variant; currently the sequences of the ref
- * and alt alleles. */
-void GetDataAboutVariant(std::stringstream& ss, std::string& refSequence,
-    std::string& altSequence) {
+/** Can a phased diploid child have inherited its haplotypes as its phase
+ * says: the first from the first parent, the second from the second? At a
+ * single site only the order of the child's alleles tells which haplotype
+ * came from which parent, so the phase of the parents does not matter. **/
+bool canBeTransmittedInPhase(const Genotype& firstParent,
+    const Genotype& secondParent, const Genotype& child) {
+  return firstParent.HasAllele(child.GetAllele(0)) &&
+      secondParent.HasAllele(child.GetAllele(1));
+}
+
+/** Classifies a trio the slow way, by looking at the individual alleles. If
+ * 'is_phase_aware', a phased diploid child is checked for the transmission
+ * of its haplotypes (see canBeTransmittedInPhase). **/
+static TrioClass GetTrioClassFromAlleles(const Genotype& firstParentGenotype,
+    const Genotype& secondParentGenotype, const Genotype& childGenotype,
+    bool is_phase_aware) {
+  if (!canAssessMendelianCorrectness(firstParentGenotype,
+      secondParentGenotype, childGenotype)) {
+    return kTrioNotAssessable;
+  }
+  if (firstParentGenotype.IsHomRef() && secondParentGenotype.IsHomRef() &&
+      childGenotype.IsHomRef()) {
+    return kTrioAllHomRef;
+  }
+  bool is_correct = (is_phase_aware && childGenotype.IsPhased() &&
+      childGenotype.GetNumberOfAlleles() == 2) ?
+      canBeTransmittedInPhase(firstParentGenotype, secondParentGenotype,
+          childGenotype) :
+      canBeMendelianCorrect(firstParentGenotype, secondParentGenotype,
+          childGenotype);
+  return is_correct ? kTrioCorrect : kTrioError;
+}
+
+/** The class of every trio of which all genotypes have a code (see
+ * Genotype::GetCode), indexed by whether the check is phase aware and by
+ * the three codes. Built once, from the slow path, so both always agree.
+ * Trios that can be assessed while a parent is unknown (haploid children)
+ * stay on the slow path, which handles (or rejects) them exactly as
+ * before. **/
+class TrioClassTable {
+public:
+  static const int SLOW_PATH = -1;
+
+  TrioClassTable() {
+    for (int is_phase_aware = 0; is_phase_aware < 2; ++is_phase_aware) {
+      for (int first_code = 0; first_code < Genotype::NUMBER_OF_CODES;
+          ++first_code) {
+        for (int second_code = 0; second_code < Genotype::NUMBER_OF_CODES;
+            ++second_code) {
+          for (int child_code = 0; child_code < Genotype::NUMBER_OF_CODES;
+              ++child_code) {
+            Genotype first_parent = Genotype::FromCode(first_code);
+            Genotype second_parent = Genotype::FromCode(second_code);
+            Genotype child = Genotype::FromCode(child_code);
+            signed char& entry =
+                table_[is_phase_aware][first_code][second_code][child_code];
+            if (canAssessMendelianCorrectness(first_parent, second_parent,
+                child) && (first_parent.IsUnknown() ||
+                second_parent.IsUnknown())) {
+              entry = SLOW_PATH;
+            }
+            else {
+              entry = GetTrioClassFromAlleles(first_parent, second_parent,
+                  child, is_phase_aware != 0);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  int Get(bool is_phase_aware, int first_code, int second_code,
+      int child_code) const {
+    return table_[is_phase_aware][first_code][second_code][child_code];
+  }
+
+private:
+  signed char table_[2][Genotype::NUMBER_OF_CODES]
+      [Genotype::NUMBER_OF_CODES][Genotype::NUMBER_OF_CODES];
+};
+
+/** Looks up the class of a trio in the table, from the codes of the
+ * genotypes (see Genotype::GetCode), such as the packed calls of the
+ * analyzer; see GetTrioClass for 'is_phase_aware'. Returns false if the
+ * codes do not tell: if a genotype has no code, or the trio is one for the
+ * slow path. **/
+bool GetTrioClassFromCodes(int first_code, int second_code, int child_code,
+    bool is_phase_aware, TrioClass* trio_class) {
+  static const TrioClassTable table;
+  if (first_code == Genotype::NO_CODE || second_code == Genotype::NO_CODE ||
+      child_code == Genotype::NO_CODE) {
+    return false;
+  }
+  int table_class = table.Get(is_phase_aware, first_code, second_code,
+      child_code);
+  if (table_class == TrioClassTable::SLOW_PATH) {
+    return false;
+  }
+  *trio_class = static_cast<TrioClass>(table_class);
+  return true;
+}
 
-  std::string dummy;
-  for (int i = 0; i < 3; i++ ) {
-    ss >> dummy;
+/** Classifies a trio: can Mendelian correctness be assessed, and if so, are
+ * all genotypes homref, or is the trio Mendelian correct or an error? If
+ * 'is_phase_aware', a phased child must have its first haplotype from the
+ * first parent and its second from the second parent; otherwise the phase
+ * is ignored. Trios of biallelic haploid/diploid genotypes are looked up in
+ * a table; the others go through canAssessMendelianCorrectness and
+ * canBeMendelianCorrect (or canBeTransmittedInPhase). **/
+TrioClass GetTrioClass(const Genotype& firstParentGenotype,
+    const Genotype& secondParentGenotype, const Genotype& childGenotype,
+    bool is_phase_aware) {
+  TrioClass trio_class;
+  if (GetTrioClassFromCodes(firstParentGenotype.GetCode(),
+      secondParentGenotype.GetCode(), childGenotype.GetCode(),
+      is_phase_aware, &trio_class)) {
+    return trio_class;
   }
-  ss >> refSequence;
-  ss >> altSequence;
+  return GetTrioClassFromAlleles(firstParentGenotype, secondParentGenotype,
+      childGenotype, is_phase_aware);
+}
+
+/** Returns basic data about this variant; currently the sequences of the ref
+ * and alt alleles. */
+void GetDataAboutVariant(const VcfRecord& record, Span* refSequence,
+    Span* altSequence) {
+  *refSequence = record.GetColumn(kRef);
+  *altSequence = record.GetColumn(kAlt);
+}
 
-  for (int i = 0; i < 4; i++ ) {
-    ss >> dummy;
+/** Gets the (1-based) position of the record; 0 if it has none. **/
+long long GetPosition(const VcfRecord& record) {
+  Span position = record.GetColumn(kPos);
+  long long value = 0;
+  for (size_t index = 0; index < position.size() &&
+      position[index] >= '0' && position[index] <= '9'; ++index) {
+    value = 10 * value + (position[index] - '0');
   }
+  return value;
 }
 
 }; // namespace BioUtils
@@ -13,14 +13,28 @@
 #define BIOUTILS_H_
 
 #include "Genotype.h"
+#include "Span.h"
+#include "VcfRecord.h"
 
 namespace BioUtils {
+  // What the genotypes of a trio say about Mendelian inheritance
+  enum TrioClass { kTrioNotAssessable, kTrioAllHomRef, kTrioCorrect,
+    kTrioError };
+
   bool canAssessMendelianCorrectness(const Genotype& firstParentGenotype,
     const Genotype& secondParentGenotype, const Genotype& childGenotype);
   bool canBeMendelianCorrect(const Genotype& firstParent,
       const Genotype& secondParent, const Genotype& child);
-  void GetDataAboutVariant(std::stringstream& ss, std::string& refSequence,
-      std::string& altSequence);
+  bool canBeTransmittedInPhase(const Genotype& firstParent,
+      const Genotype& secondParent, const Genotype& child);
+  TrioClass GetTrioClass(const Genotype& firstParentGenotype,
+      const Genotype& secondParentGenotype, const Genotype& childGenotype,
+      bool is_phase_aware);
+  bool GetTrioClassFromCodes(int first_code, int second_code, int child_code,
+      bool is_phase_aware, TrioClass* trio_class);
+  void GetDataAboutVariant(const VcfRecord& record, Span* refSequence,
+      Span* altSequence);
+  long long GetPosition(const VcfRecord& record);
 
 }; // namespace bioutils
 
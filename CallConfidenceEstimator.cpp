@@ -7,40 +7,58 @@
 
 #include "CallConfidenceEstimator.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include "Utilities.h"
 
 
+/** Constructor; reads the quality files (as written by an earlier run) from
+ * the working directory. Without them, every call is trusted completely,
+ * until Calibrate is called. **/
 CallConfidenceEstimator::CallConfidenceEstimator() {
+  Calibrate(Statistics());
+
   // Step 1: read in coverage qualities
   std::ifstream coverage_quality_file("coverage_qualities.txt");
-  coverage_quality_file >> max_support_ >> support_per_bin_;
-  for (int i = 0; i <= max_support_ / support_per_bin_; i++ ) {
-    int index;
-    double confidence;
-
-    coverage_quality_file >> index >> confidence;
-    coverage_confidences_.push_back(confidence);
+  if (coverage_quality_file.good()) {
+    coverage_quality_file >> max_support_ >> support_per_bin_;
+    coverage_confidences_.clear();
+    for (int i = 0; i <= max_support_ / support_per_bin_; i++ ) {
+      int index;
+      double confidence;
+
+      coverage_quality_file >> index >> confidence;
+      coverage_confidences_.push_back(confidence);
+    }
   }
   coverage_quality_file.close();
 
   // Step 2: read in VAF-related qualities
   std::ifstream vaf_quality_file("vaf_qualities.txt");
-
-  vaf_quality_file >> num_vaf_bins_;
-  for (int i = 0; i <= num_vaf_bins_; i++ ) {
-    int index;
-    double confidence;
-
-    vaf_quality_file >> index >> confidence;
-    vaf_confidences_.push_back(confidence);
+  if (vaf_quality_file.good()) {
+    vaf_quality_file >> num_vaf_bins_;
+    vaf_confidences_.clear();
+    for (int i = 0; i <= num_vaf_bins_; i++ ) {
+      int index;
+      double confidence;
+
+      vaf_quality_file >> index >> confidence;
+      vaf_confidences_.push_back(confidence);
+    }
   }
   vaf_quality_file.close();
 
   // Step 3: read in event-related qualities
   std::ifstream event_quality_file("event_qualities.txt");
-  do {
+  if (event_quality_file.good()) {
+    // event types missing from the event quality file get confidence 0
+    for (int event_type = 0; event_type < NUMBER_OF_EVENT_TYPES;
+        ++event_type) {
+      eventtype_confidences_[event_type] = 0.0;
+    }
+  }
+  while (event_quality_file.is_open()) {
     std::string event_name;
     double confidence;
     event_quality_file >> event_name >> confidence;
@@ -51,29 +69,65 @@ CallConfidenceEstimator::CallConfidenceEstimator() {
         Utilities::GetUntilFirstOccurrenceOf(event_name,':');
     EventType event_type = GetEventTypeFromString(event_name_minus_colon);
     eventtype_confidences_[event_type] = confidence;
-  } while (true);
+  }
   event_quality_file.close();
 }
 
+/** Takes the confidences from the qualities (the fractions of calls that
+ * are Mendelian correct) per coverage, VAF and event type of 'statistics',
+ * instead of from the quality files. Bins without calls get confidence 1.
+ * **/
+void CallConfidenceEstimator::Calibrate(const Statistics& statistics) {
+  max_support_ = Statistics::MAX_SUPPORT;
+  support_per_bin_ = Statistics::COVERAGE_RESOLUTION;
+  num_vaf_bins_ = Statistics::NUM_VAF_BINS;
+  coverage_confidences_.clear();
+  for (int index = 0; index <= max_support_ / support_per_bin_; ++index) {
+    coverage_confidences_.push_back(
+        statistics.coverage_qualities[index].GetCorrectnessFraction());
+  }
+  vaf_confidences_.clear();
+  for (int index = 0; index <= num_vaf_bins_; ++index) {
+    vaf_confidences_.push_back(
+        statistics.vaf_qualities[index].GetCorrectnessFraction());
+  }
+  for (int event_type = 0; event_type < NUMBER_OF_EVENT_TYPES; ++event_type) {
+    eventtype_confidences_[event_type] =
+        statistics.eventtype_qualities[event_type].GetCorrectnessFraction();
+  }
+}
+
 CallConfidenceEstimator::~CallConfidenceEstimator() {
   // TODO Auto-generated destructor stub
 }
 
-/** What is the confidence in a certain prediction of a genotype? **/
-double CallConfidenceEstimator::GetConfidence(const Event& event, const Support& support) {
+/** What is the confidence in a certain prediction of a genotype? The type
+ * and VAF are those of the alt allele the call is about. Does not change the
+ * estimator, so it can be shared by several threads. **/
+double CallConfidenceEstimator::GetConfidence(const Event& event,
+    const GenotypingResults& results) const {
+  const Support& support = results.GetSupport();
 
   double min_confidence = 1.0;
-  double event_type_confidence = eventtype_confidences_[event.GetType()];
+  double event_type_confidence =
+      eventtype_confidences_[event.GetType(results.GetAltAllele(event))];
   min_confidence = std::min(min_confidence, event_type_confidence);
 
+  // coverage beyond the last bin counts as that of the last bin
   int coverage_bin_index = support.GetTotalSupport() / support_per_bin_;
+  coverage_bin_index = std::max(0, std::min(coverage_bin_index,
+      static_cast<int>(coverage_confidences_.size()) - 1));
   double coverage_confidence = coverage_confidences_[coverage_bin_index];
   min_confidence = std::min(min_confidence, coverage_confidence);
 
-  int vaf_bin_index = support.GetVaf() * num_vaf_bins_;
-  double vaf_confidence = vaf_confidences_[vaf_bin_index];
-  //std::cout << "[va]" <<support.GetVaf() << "[vn]" << num_vaf_bins_ << "[vb]" << vaf_bin_index << "[vc]" << vaf_confidence << "[]";
-  min_confidence = std::min(min_confidence, vaf_confidence);
+  // without a VAF (no AD counts, or none at all), the VAF says nothing
+  double vaf = results.GetVaf(event);
+  if (vaf >= 0.0) {
+    int vaf_bin_index = vaf * num_vaf_bins_;
+    double vaf_confidence = vaf_confidences_[vaf_bin_index];
+    //std::cout << "[va]" <<support.GetVaf() << "[vn]" << num_vaf_bins_ << "[vb]" << vaf_bin_index << "[vc]" << vaf_confidence << "[]";
+    min_confidence = std::min(min_confidence, vaf_confidence);
+  }
 
   return min_confidence;
 
@@ -13,18 +13,20 @@
 #ifndef CALLCONFIDENCEESTIMATOR_H_
 #define CALLCONFIDENCEESTIMATOR_H_
 
-#include <map>
 #include <vector>
 
 #include "Event.h"
-#include "Support.h"
+#include "GenotypingResults.h"
+#include "Statistics.h"
 
 class CallConfidenceEstimator {
 public:
   CallConfidenceEstimator();
   virtual ~CallConfidenceEstimator();
 
-  double GetConfidence(const Event& event, const Support& support);
+  void Calibrate(const Statistics& statistics);
+  double GetConfidence(const Event& event,
+      const GenotypingResults& results) const;
 
 private:
 
@@ -33,7 +35,7 @@ private:
   int num_vaf_bins_;
 
   std::vector<double> coverage_confidences_;
-  std::map<EventType, double> eventtype_confidences_;
+  double eventtype_confidences_[NUMBER_OF_EVENT_TYPES];
   std::vector<double> vaf_confidences_;
 };
 
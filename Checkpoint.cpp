@@ -0,0 +1,96 @@
+/*
+ * Checkpoint.cpp
+ *
+ * The state of an analysis that is under way: how far into the input file
+ * it has got, how much of the output file has been written, and the counts
+ * so far. Written regularly during long runs, so that an interrupted run can
+ * continue where the last checkpoint was made instead of starting over.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "Checkpoint.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Utilities.h"
+
+namespace {
+
+const char* const FIRST_LINE = "# mendelian_analyzer checkpoint, version 2";
+
+} // namespace
+
+/** Constructor; a checkpoint at the start of the input. **/
+Checkpoint::Checkpoint() : size_of_input_file(0), input_offset(0),
+    output_size(0) {
+}
+
+/** Returns the size of a file; 0 if it is not a regular file. **/
+unsigned long long Checkpoint::GetSizeOfFile(
+    const std::string& name_of_file) {
+  struct stat file_status;
+  if (stat(name_of_file.c_str(), &file_status) != 0 ||
+      !S_ISREG(file_status.st_mode)) {
+    return 0;
+  }
+  return file_status.st_size;
+}
+
+/** Reads a checkpoint written by Write; aborts if it cannot. **/
+void Checkpoint::Read(const std::string& name_of_checkpoint_file) {
+  std::ifstream checkpoint_file(name_of_checkpoint_file.c_str());
+  Utilities::Require(checkpoint_file.good(), "Checkpoint error: cannot "
+      "open checkpoint file '" + name_of_checkpoint_file + "'.");
+  std::string first_line;
+  std::getline(checkpoint_file, first_line);
+  Utilities::Require(first_line == FIRST_LINE, "Checkpoint error: '" +
+      name_of_checkpoint_file + "' is not a checkpoint file of this "
+      "version.");
+  std::getline(checkpoint_file, name_of_input_file);
+  checkpoint_file >> size_of_input_file >> input_offset >> output_size;
+  statistics.ReadFrom(checkpoint_file);
+  size_t number_of_configurations = 0;
+  checkpoint_file >> number_of_configurations;
+  configuration_statistics.resize(checkpoint_file.fail() ? 0 :
+      number_of_configurations);
+  for (size_t index = 0; index < configuration_statistics.size(); ++index) {
+    configuration_statistics[index].ReadFrom(checkpoint_file);
+  }
+  Utilities::Require(!checkpoint_file.fail(), "Checkpoint error: "
+      "checkpoint file '" + name_of_checkpoint_file + "' is damaged.");
+}
+
+/** Writes the checkpoint to a temporary file, which is put on disk and then
+ * replaces the checkpoint file, so that there is always one complete
+ * checkpoint even if the run is killed while writing. **/
+void Checkpoint::Write(const std::string& name_of_checkpoint_file) const {
+  std::stringstream contents;
+  contents << FIRST_LINE << "\n" << name_of_input_file << "\n" <<
+      size_of_input_file << " " << input_offset << " " << output_size << "\n";
+  statistics.WriteTo(contents);
+  contents << "\n" << configuration_statistics.size();
+  for (size_t index = 0; index < configuration_statistics.size(); ++index) {
+    contents << "\n";
+    configuration_statistics[index].WriteTo(contents);
+  }
+  contents << "\n";
+  std::string text = contents.str();
+
+  std::string name_of_temporary_file = name_of_checkpoint_file + ".tmp";
+  FILE* temporary_file = fopen(name_of_temporary_file.c_str(), "w");
+  bool is_written = temporary_file != NULL &&
+      fwrite(text.data(), 1, text.size(), temporary_file) == text.size() &&
+      fflush(temporary_file) == 0 && fsync(fileno(temporary_file)) == 0;
+  if (temporary_file != NULL) {
+    is_written = (fclose(temporary_file) == 0) && is_written;
+  }
+  Utilities::Require(is_written && rename(name_of_temporary_file.c_str(),
+      name_of_checkpoint_file.c_str()) == 0, "Checkpoint error: cannot "
+      "write checkpoint file '" + name_of_checkpoint_file + "'.");
+}
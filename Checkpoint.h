@@ -0,0 +1,40 @@
+/*
+ * Checkpoint.h
+ *
+ * The state of an analysis that is under way: how far into the input file
+ * it has got, how much of the output file has been written, and the counts
+ * so far. Written regularly during long runs, so that an interrupted run can
+ * continue where the last checkpoint was made instead of starting over.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <string>
+#include <vector>
+
+#include "Statistics.h"
+
+struct Checkpoint {
+  Checkpoint();
+
+  void Read(const std::string& name_of_checkpoint_file);
+  void Write(const std::string& name_of_checkpoint_file) const;
+
+  static unsigned long long GetSizeOfFile(const std::string& name_of_file);
+
+  std::string name_of_input_file;
+  // the size of the input file, to notice if it has changed since
+  unsigned long long size_of_input_file;
+  // the offset in the (decompressed) input of the first line not yet
+  // analyzed, and the size of the output file up to that line
+  unsigned long long input_offset;
+  unsigned long long output_size;
+  Statistics statistics;
+  // the counts of the extra configurations, if any
+  std::vector<Statistics> configuration_statistics;
+};
+
+#endif /* CHECKPOINT_H_ */
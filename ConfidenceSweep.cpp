@@ -0,0 +1,180 @@
+/*
+ * ConfidenceSweep.cpp
+ *
+ * Counts the calls and trios for a whole range of minimal confidences at
+ * once, so that a single pass shows how the Mendelian error rate changes
+ * with the call rate. Every call is kept up to the highest threshold that
+ * its confidence reaches; a trio therefore changes class at most three
+ * times over the range. Each count is stored as a difference array over
+ * the thresholds: adding a call or a trio costs a few increments, and the
+ * counts per threshold are the running sums.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "ConfidenceSweep.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "BioUtils.h"
+
+/** Constructor; nothing counted yet. **/
+ConfidenceSweep::ConfidenceSweep() {
+  std::fill(&differences_[0][0],
+      &differences_[0][0] + NUMBER_OF_SWEEP_COUNTS * NUMBER_OF_DIFFERENCES, 0);
+}
+
+/** Returns the minimal confidence of a step. Calculated the same way as the
+ * value of a 'cX' argument is read, so that a step gives exactly the counts
+ * of a run with that argument. **/
+double ConfidenceSweep::GetThreshold(int step) {
+  return step / static_cast<double>(NUMBER_OF_STEPS);
+}
+
+/** Returns the last step at which a call with this confidence is kept (its
+ * confidence is not below the threshold); -1 if it is never kept. **/
+int ConfidenceSweep::GetLastStep(double confidence) {
+  if (!(confidence >= 0.0)) {
+    return -1;
+  }
+  int step = static_cast<int>(std::min(
+      static_cast<double>(NUMBER_OF_STEPS),
+      std::floor(confidence * NUMBER_OF_STEPS)));
+  // the product may be rounded either way
+  while (step >= 0 && GetThreshold(step) > confidence) {
+    --step;
+  }
+  while (step < NUMBER_OF_STEPS && GetThreshold(step + 1) <= confidence) {
+    ++step;
+  }
+  return step;
+}
+
+/** Adds one to a count for the steps 'first_step' to 'last_step'. **/
+void ConfidenceSweep::AddRange(SweepCount count, int first_step,
+    int last_step) {
+  if (first_step <= last_step) {
+    ++differences_[count][first_step];
+    --differences_[count][last_step + 1];
+  }
+}
+
+/** Adds the call of a sample: from the first threshold above its
+ * confidence on, it is unknown. **/
+void ConfidenceSweep::AddCall(const Genotype& genotype, double confidence) {
+  int last_step = genotype.IsUnknown() ? -1 : GetLastStep(confidence);
+  SweepCount kept_count = genotype.IsUnknown() ? kSweepUnknownCalls :
+      (genotype.IsHomRef() ? kSweepHomrefCalls : kSweepVariantCalls);
+  AddRange(kept_count, 0, last_step);
+  AddRange(kSweepUnknownCalls, last_step + 1, NUMBER_OF_STEPS);
+}
+
+/** Adds an event, which counts as long as its most confident variant call
+ * is kept. **/
+void ConfidenceSweep::AddEvent(double highest_variant_confidence) {
+  AddRange(kSweepEvents, 0, GetLastStep(highest_variant_confidence));
+}
+
+/** Adds a trio, classified as BioUtils::GetTrioClass does. Over the range of
+ * thresholds, its members become unknown one by one; in between, the class
+ * of the trio stays the same. **/
+void ConfidenceSweep::AddTrio(const Genotype& firstParentGenotype,
+    const Genotype& secondParentGenotype, const Genotype& childGenotype,
+    const double confidences[3], bool is_phase_aware) {
+  const Genotype* genotypes[3] = { &firstParentGenotype,
+      &secondParentGenotype, &childGenotype };
+  int last_steps[3];
+  for (int member = 0; member < 3; ++member) {
+    last_steps[member] = genotypes[member]->IsUnknown() ? -1 :
+        GetLastStep(confidences[member]);
+  }
+  int ends_of_ranges[4] = { last_steps[0], last_steps[1], last_steps[2],
+      NUMBER_OF_STEPS };
+  std::sort(ends_of_ranges, ends_of_ranges + 4);
+
+  int first_step = 0;
+  for (int range = 0; range < 4; ++range) {
+    int last_step = ends_of_ranges[range];
+    if (last_step < first_step) {
+      continue;
+    }
+    Genotype calls[3] = { firstParentGenotype, secondParentGenotype,
+        childGenotype };
+    for (int member = 0; member < 3; ++member) {
+      if (last_steps[member] < first_step) {
+        calls[member].SetToUnknown();
+      }
+    }
+    switch (BioUtils::GetTrioClass(calls[0], calls[1], calls[2],
+        is_phase_aware)) {
+    case BioUtils::kTrioAllHomRef:
+      AddRange(kSweepAllHomrefTrios, first_step, last_step);
+      break;
+    case BioUtils::kTrioCorrect:
+      AddRange(kSweepCorrectTrios, first_step, last_step);
+      break;
+    case BioUtils::kTrioError:
+      AddRange(kSweepErrorTrios, first_step, last_step);
+      break;
+    case BioUtils::kTrioNotAssessable:
+      AddRange(kSweepUnknownTrios, first_step, last_step);
+      break;
+    }
+    first_step = last_step + 1;
+  }
+}
+
+/** Returns a count at a step (see GetThreshold). **/
+long long ConfidenceSweep::GetCount(SweepCount count, int step) const {
+  long long sum = 0;
+  for (int index = 0; index <= step; ++index) {
+    sum += differences_[count][index];
+  }
+  return sum;
+}
+
+/** Adds the counts of 'other' to these. **/
+void ConfidenceSweep::Merge(const ConfidenceSweep& other) {
+  for (int count = 0; count < NUMBER_OF_SWEEP_COUNTS; ++count) {
+    for (int index = 0; index < NUMBER_OF_DIFFERENCES; ++index) {
+      differences_[count][index] += other.differences_[count][index];
+    }
+  }
+}
+
+/** Reads the counts as written by WriteTo, replacing the current ones. **/
+void ConfidenceSweep::ReadFrom(std::istream& is) {
+  *this = ConfidenceSweep();
+  int number_of_differences = 0;
+  is >> number_of_differences;
+  for (int read = 0; read < number_of_differences && is; ++read) {
+    int index = 0;
+    long long difference = 0;
+    is >> index >> difference;
+    if (index >= 0 &&
+        index < NUMBER_OF_SWEEP_COUNTS * NUMBER_OF_DIFFERENCES) {
+      differences_[index / NUMBER_OF_DIFFERENCES]
+          [index % NUMBER_OF_DIFFERENCES] = difference;
+    }
+    else {
+      is.setstate(std::ios::failbit);
+    }
+  }
+}
+
+/** Writes the counts, so they can be read back with ReadFrom: the number of
+ * differences that are not zero, and their indices and values. Without a
+ * sweep, that is a single 0. **/
+void ConfidenceSweep::WriteTo(std::ostream& os) const {
+  const long long* begin = &differences_[0][0];
+  const long long* end = begin +
+      NUMBER_OF_SWEEP_COUNTS * NUMBER_OF_DIFFERENCES;
+  os << (end - begin) - std::count(begin, end, 0);
+  for (const long long* difference = begin; difference != end;
+      ++difference) {
+    if (*difference != 0) {
+      os << " " << difference - begin << " " << *difference;
+    }
+  }
+}
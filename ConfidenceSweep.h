@@ -0,0 +1,55 @@
+/*
+ * ConfidenceSweep.h
+ *
+ * Counts the calls and trios for a whole range of minimal confidences at
+ * once, so that a single pass shows how the Mendelian error rate changes
+ * with the call rate. Every call is kept up to the highest threshold that
+ * its confidence reaches; a trio therefore changes class at most three
+ * times over the range. Each count is stored as a difference array over
+ * the thresholds: adding a call or a trio costs a few increments, and the
+ * counts per threshold are the running sums.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef CONFIDENCESWEEP_H_
+#define CONFIDENCESWEEP_H_
+
+#include <iostream>
+
+#include "Genotype.h"
+
+enum SweepCount { kSweepUnknownCalls, kSweepHomrefCalls, kSweepVariantCalls,
+  kSweepEvents, kSweepUnknownTrios, kSweepAllHomrefTrios,
+  kSweepCorrectTrios, kSweepErrorTrios };
+const int NUMBER_OF_SWEEP_COUNTS = kSweepErrorTrios + 1;
+
+class ConfidenceSweep {
+public:
+  ConfidenceSweep();
+
+  void AddCall(const Genotype& genotype, double confidence);
+  void AddEvent(double highest_variant_confidence);
+  void AddTrio(const Genotype& firstParentGenotype,
+      const Genotype& secondParentGenotype, const Genotype& childGenotype,
+      const double confidences[3], bool is_phase_aware);
+  long long GetCount(SweepCount count, int step) const;
+  static double GetThreshold(int step);
+  void Merge(const ConfidenceSweep& other);
+  void ReadFrom(std::istream& is);
+  void WriteTo(std::ostream& os) const;
+
+  // the thresholds are 0, 1 / NUMBER_OF_STEPS, ..., 1
+  static const int NUMBER_OF_STEPS = 100;
+
+private:
+  static int GetLastStep(double confidence);
+  void AddRange(SweepCount count, int first_step, int last_step);
+
+  static const int NUMBER_OF_DIFFERENCES = NUMBER_OF_STEPS + 2;
+
+  // per count, the change in the count from the previous step to this one
+  long long differences_[NUMBER_OF_SWEEP_COUNTS][NUMBER_OF_DIFFERENCES];
+};
+
+#endif /* CONFIDENCESWEEP_H_ */
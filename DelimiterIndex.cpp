@@ -0,0 +1,236 @@
+/*
+ * DelimiterIndex.cpp
+ *
+ * Marks where the tabs and colons are in the sample columns of a VCF line,
+ * one bit per character, so that the columns and the fields in them can be
+ * found without scanning the text byte by byte again. The bitmaps are built
+ * in a single pass over the text, 32 or 16 characters at a time with AVX2 or
+ * SSE2 where the processor has them, and one character at a time elsewhere.
+ * Which of these is used is decided when the program starts.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "DelimiterIndex.h"
+
+#include "Utilities.h"
+
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+#define DELIMITER_INDEX_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// fills the bitmaps of 'size' characters of text, 64 characters per word
+typedef void (*BuildFunction)(const char* text, size_t size,
+    unsigned long long* tab_bits, unsigned long long* colon_bits);
+
+/** Marks the delimiters one character at a time; also finishes the last
+ * (partial) word for the vectorized functions. **/
+void BuildScalar(const char* text, size_t size, unsigned long long* tab_bits,
+    unsigned long long* colon_bits) {
+  for (size_t start = 0; start < size; start += 64) {
+    size_t length = (size - start < 64) ? size - start : 64;
+    unsigned long long tab_word = 0;
+    unsigned long long colon_word = 0;
+    for (size_t index = 0; index < length; ++index) {
+      tab_word |= static_cast<unsigned long long>(
+          text[start + index] == '\t') << index;
+      colon_word |= static_cast<unsigned long long>(
+          text[start + index] == ':') << index;
+    }
+    tab_bits[start / 64] = tab_word;
+    colon_bits[start / 64] = colon_word;
+  }
+}
+
+#ifdef DELIMITER_INDEX_X86
+
+/** Marks the delimiters 16 characters at a time; every x86-64 processor
+ * has SSE2. **/
+void BuildWithSse2(const char* text, size_t size,
+    unsigned long long* tab_bits, unsigned long long* colon_bits) {
+  const __m128i tabs = _mm_set1_epi8('\t');
+  const __m128i colons = _mm_set1_epi8(':');
+  size_t number_of_words = size / 64;
+  for (size_t word_index = 0; word_index < number_of_words; ++word_index) {
+    unsigned long long tab_word = 0;
+    unsigned long long colon_word = 0;
+    for (int part = 0; part < 4; ++part) {
+      __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+          text + 64 * word_index + 16 * part));
+      tab_word |= static_cast<unsigned long long>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(characters, tabs))) << (16 * part);
+      colon_word |= static_cast<unsigned long long>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(characters, colons))) <<
+          (16 * part);
+    }
+    tab_bits[word_index] = tab_word;
+    colon_bits[word_index] = colon_word;
+  }
+  BuildScalar(text + 64 * number_of_words, size - 64 * number_of_words,
+      tab_bits + number_of_words, colon_bits + number_of_words);
+}
+
+/** Marks the delimiters 32 characters at a time. Compiled for AVX2 on its
+ * own, so that the rest of the program still runs on processors without
+ * it. **/
+__attribute__((target("avx2")))
+void BuildWithAvx2(const char* text, size_t size,
+    unsigned long long* tab_bits, unsigned long long* colon_bits) {
+  const __m256i tabs = _mm256_set1_epi8('\t');
+  const __m256i colons = _mm256_set1_epi8(':');
+  size_t number_of_words = size / 64;
+  for (size_t word_index = 0; word_index < number_of_words; ++word_index) {
+    const char* block = text + 64 * word_index;
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i high = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(block + 32));
+    tab_bits[word_index] = static_cast<unsigned int>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, tabs))) |
+        static_cast<unsigned long long>(static_cast<unsigned int>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, tabs)))) << 32;
+    colon_bits[word_index] = static_cast<unsigned int>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(low, colons))) |
+        static_cast<unsigned long long>(static_cast<unsigned int>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(high, colons)))) << 32;
+  }
+  BuildScalar(text + 64 * number_of_words, size - 64 * number_of_words,
+      tab_bits + number_of_words, colon_bits + number_of_words);
+}
+
+#endif
+
+struct Implementation {
+  const char* name;
+  BuildFunction build;
+};
+
+// from the fastest to the slowest; the first one the processor can run is
+// used
+const Implementation IMPLEMENTATIONS[] = {
+#ifdef DELIMITER_INDEX_X86
+    { "AVX2", BuildWithAvx2 },
+    { "SSE2", BuildWithSse2 },
+#endif
+    { "scalar", BuildScalar } };
+const int NUMBER_OF_IMPLEMENTATIONS =
+    sizeof(IMPLEMENTATIONS) / sizeof(IMPLEMENTATIONS[0]);
+
+/** Can this processor run the implementation? **/
+bool IsSupported(const Implementation& implementation) {
+#ifdef DELIMITER_INDEX_X86
+  if (implementation.build == BuildWithAvx2) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }
+#endif
+  return true;
+}
+
+/** Returns the fastest implementation that this processor can run. **/
+const Implementation* ChooseImplementation() {
+  for (int index = 0; index < NUMBER_OF_IMPLEMENTATIONS; ++index) {
+    if (IsSupported(IMPLEMENTATIONS[index])) {
+      return &IMPLEMENTATIONS[index];
+    }
+  }
+  return &IMPLEMENTATIONS[NUMBER_OF_IMPLEMENTATIONS - 1];
+}
+
+const Implementation* chosen_implementation = ChooseImplementation();
+
+} // namespace
+
+/** Constructor; the index is empty until Build is called. **/
+DelimiterIndex::DelimiterIndex() {
+}
+
+/** Marks the tabs and colons of 'text', which should stay in place for as
+ * long as the index is used. **/
+void DelimiterIndex::Build(const Span& text) {
+  text_ = text;
+  size_t number_of_words = (text.size() + 63) / 64;
+  tab_bits_.resize(number_of_words);
+  colon_bits_.resize(number_of_words);
+  if (number_of_words > 0) {
+    chosen_implementation->build(text.begin(), text.size(), &tab_bits_[0],
+        &colon_bits_[0]);
+  }
+}
+
+/** Splits the text at its tabs into 'columns'; empty columns (stray tabs)
+ * are skipped. The tabs are taken from the bitmap a word at a time, so the
+ * text itself is not read again. **/
+void DelimiterIndex::SplitAtTabs(std::vector<Span>* columns) const {
+  columns->clear();
+  size_t start_of_column = 0;
+  for (size_t word_index = 0; word_index < tab_bits_.size(); ++word_index) {
+    for (unsigned long long word = tab_bits_[word_index]; word != 0;
+        word &= word - 1) {
+      size_t tab = 64 * word_index + __builtin_ctzll(word);
+      if (tab > start_of_column) {
+        columns->push_back(Span(text_.begin() + start_of_column,
+            text_.begin() + tab));
+      }
+      start_of_column = tab + 1;
+    }
+  }
+  if (text_.size() > start_of_column) {
+    columns->push_back(Span(text_.begin() + start_of_column, text_.end()));
+  }
+}
+
+/** Builds the bitmaps of 'text' with every instruction set that this
+ * processor has, and compares them with those built one character at a
+ * time. Returns the name of the first instruction set that marks other tabs
+ * or colons, or NULL if they all agree. For tests; allocates. **/
+const char* DelimiterIndex::FindDisagreeingInstructionSet(const Span& text) {
+  size_t number_of_words = (text.size() + 63) / 64;
+  if (number_of_words == 0) {
+    return NULL;
+  }
+  std::vector<unsigned long long> expected_tab_bits(number_of_words);
+  std::vector<unsigned long long> expected_colon_bits(number_of_words);
+  BuildScalar(text.begin(), text.size(), &expected_tab_bits[0],
+      &expected_colon_bits[0]);
+  std::vector<unsigned long long> tab_bits;
+  std::vector<unsigned long long> colon_bits;
+  for (int index = 0; index < NUMBER_OF_IMPLEMENTATIONS; ++index) {
+    if (!IsSupported(IMPLEMENTATIONS[index])) {
+      continue;
+    }
+    // every word has to be written, so none may keep these bits
+    tab_bits.assign(number_of_words, ~0ULL);
+    colon_bits.assign(number_of_words, ~0ULL);
+    IMPLEMENTATIONS[index].build(text.begin(), text.size(), &tab_bits[0],
+        &colon_bits[0]);
+    if (tab_bits != expected_tab_bits || colon_bits != expected_colon_bits) {
+      return IMPLEMENTATIONS[index].name;
+    }
+  }
+  return NULL;
+}
+
+/** Returns the name of the instruction set the bitmaps are built with
+ * ("AVX2", "SSE2" or "scalar"). **/
+const char* DelimiterIndex::GetInstructionSet() {
+  return chosen_implementation->name;
+}
+
+/** Builds the bitmaps with the named instruction set from now on (to compare
+ * them, for example). Returns false, and changes nothing, if the name is
+ * unknown or the processor does not have that instruction set. Call before
+ * any threads are started. **/
+bool DelimiterIndex::UseInstructionSet(const std::string& name) {
+  for (int index = 0; index < NUMBER_OF_IMPLEMENTATIONS; ++index) {
+    if (Utilities::StringToLowerCase(IMPLEMENTATIONS[index].name) ==
+        Utilities::StringToLowerCase(name) &&
+        IsSupported(IMPLEMENTATIONS[index])) {
+      chosen_implementation = &IMPLEMENTATIONS[index];
+      return true;
+    }
+  }
+  return false;
+}
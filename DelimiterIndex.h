@@ -0,0 +1,74 @@
+/*
+ * DelimiterIndex.h
+ *
+ * Marks where the tabs and colons are in the sample columns of a VCF line,
+ * one bit per character, so that the columns and the fields in them can be
+ * found without scanning the text byte by byte again. The bitmaps are built
+ * in a single pass over the text, 32 or 16 characters at a time with AVX2 or
+ * SSE2 where the processor has them, and one character at a time elsewhere.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef DELIMITERINDEX_H_
+#define DELIMITERINDEX_H_
+
+#include <string>
+#include <vector>
+
+#include "Span.h"
+
+class DelimiterIndex {
+public:
+  DelimiterIndex();
+
+  void Build(const Span& text);
+  const char* FindColon(const char* position, const char* end) const;
+  void SplitAtTabs(std::vector<Span>* columns) const;
+
+  static const char* FindDisagreeingInstructionSet(const Span& text);
+  static const char* GetInstructionSet();
+  static bool UseInstructionSet(const std::string& name);
+
+private:
+  const char* Find(const std::vector<unsigned long long>& bits,
+      const char* position, const char* end) const;
+
+  Span text_;
+  // bit i of word w is set if character 64 * w + i of the text is a tab
+  // (colon); the vectors keep their capacity from line to line
+  std::vector<unsigned long long> tab_bits_;
+  std::vector<unsigned long long> colon_bits_;
+};
+
+/** Returns the first delimiter marked in 'bits' from 'position' on, or
+ * 'end' if there is none before 'end' (which should be in the text).
+ * Defined here as it is called for every field of every sample. **/
+inline const char* DelimiterIndex::Find(
+    const std::vector<unsigned long long>& bits, const char* position,
+    const char* end) const {
+  if (position >= end) {
+    return end;
+  }
+  size_t offset = position - text_.begin();
+  size_t end_offset = end - text_.begin();
+  size_t word_index = offset / 64;
+  unsigned long long word = bits[word_index] & (~0ULL << (offset % 64));
+  while (word == 0) {
+    if (64 * ++word_index >= end_offset) {
+      return end;
+    }
+    word = bits[word_index];
+  }
+  size_t found = 64 * word_index + __builtin_ctzll(word);
+  return (found < end_offset) ? text_.begin() + found : end;
+}
+
+/** Returns the first colon from 'position' on, or 'end' if there is none
+ * before 'end'. **/
+inline const char* DelimiterIndex::FindColon(const char* position,
+    const char* end) const {
+  return Find(colon_bits_, position, end);
+}
+
+#endif /* DELIMITERINDEX_H_ */
@@ -13,10 +13,24 @@
 
 #include "Utilities.h"
 
-/** Event constructor **/
-Event::Event(const std::string& reference, const std::string& alt) {
-  reference_ = reference;
-  alternatives_ = Utilities::Split(alt,',');
+/** Event constructor; 'alt' holds the comma-separated alt alleles. **/
+Event::Event(const Span& reference, const Span& alt) :
+    reference_size_(static_cast<int>(reference.size())),
+    number_of_alt_alleles_(0) {
+  Span alleles = alt;
+  while (true) {
+    Span allele = alleles.Until(',');
+    if (number_of_alt_alleles_ < MAX_STORED_ALT_ALLELES) {
+      alt_sizes_[number_of_alt_alleles_] =
+          (allele.size() == 1 && allele[0] == '*') ?
+          UNSIZED_ALLELE : static_cast<int>(allele.size());
+    }
+    ++number_of_alt_alleles_;
+    if (allele.size() == alleles.size()) {
+      break; // no more commas
+    }
+    alleles = alleles.After(',');
+  }
 }
 
 Event::~Event() {
@@ -29,21 +43,62 @@ Event::~Event() {
 int Event::AltSize() const {
   Utilities::Require(HasSingleAltAllele(),
       "Event::AltSize() error: there are multiple alt alleles");
-  return static_cast<int>(alternatives_[0].size());
+  return alt_sizes_[0];
+}
+
+/** Get the size of one of the alternative alleles (1 for the first, as in
+ * the GT field), or UNSIZED_ALLELE. Only the first MAX_STORED_ALT_ALLELES
+ * alt alleles have a size. **/
+int Event::AltSize(int alt_allele) const {
+  if (alt_allele < 1 || alt_allele > GetNumberOfStoredAltAlleles()) {
+    Utilities::Require(false, "Event::AltSize(int) error: the alt allele "
+        "has no size.");
+  }
+  return alt_sizes_[alt_allele - 1];
+}
+
+/** Get the number of alternative alleles. **/
+int Event::GetNumberOfAltAlleles() const {
+  return number_of_alt_alleles_;
+}
+
+/** Does the event have more alternative alleles than the ones of which the
+ * size is kept? The others are never analyzed. **/
+bool Event::HasUnstoredAltAlleles() const {
+  return number_of_alt_alleles_ > MAX_STORED_ALT_ALLELES;
 }
 
-/** What kind of type is this event? **/
+/** Get the number of alternative alleles of which the size is kept. **/
+int Event::GetNumberOfStoredAltAlleles() const {
+  return (number_of_alt_alleles_ < MAX_STORED_ALT_ALLELES) ?
+      number_of_alt_alleles_ : MAX_STORED_ALT_ALLELES;
+}
+
+/** What kind of type is this event? Events with more than one alt allele
+ * have a type per alt allele (see GetType(int)). **/
 EventType Event::GetType() const {
   if (!HasSingleAltAllele()) {
     return kUnknown;
   }
-  if (RefSize() == 1 && AltSize() == 1) {
+  return GetType(1);
+}
+
+/** What kind of event is one of the alternative alleles (1 for the first)
+ * compared to the reference? kUnknown for an unsized allele, and for one of
+ * which the size is not kept. **/
+EventType Event::GetType(int alt_allele) const {
+  if (alt_allele < 1 || alt_allele > GetNumberOfStoredAltAlleles() ||
+      alt_sizes_[alt_allele - 1] == UNSIZED_ALLELE) {
+    return kUnknown;
+  }
+  int alt_size = alt_sizes_[alt_allele - 1];
+  if (RefSize() == 1 && alt_size == 1) {
     return kSnp;
   }
-  else if (RefSize() == 1 && AltSize() > 1) {
+  else if (RefSize() == 1 && alt_size > 1) {
     return kIns;
   }
-  else if (RefSize() > 1 && AltSize() == 1) {
+  else if (RefSize() > 1 && alt_size == 1) {
     return kDel;
   }
   else {
@@ -54,27 +109,28 @@ EventType Event::GetType() const {
 /** Does this event only have a single alternative allele (as opposed to
     multiple? **/
 bool Event::HasSingleAltAllele() const {
-  return alternatives_.size() == 1;
+  return number_of_alt_alleles_ == 1;
 }
 
 /** Returns the size of the reference allele. **/
 int Event::RefSize() const {
-  return static_cast<int>(reference_.size());
+  return reference_size_;
 }
 
 /** Transforms the name of an event to the type of event. **/
 EventType GetEventTypeFromString(const std::string& input) {
-  std::map<std::string, EventType> event_name_map;
-  event_name_map["snp"] = kSnp;
-  event_name_map["ins"] = kIns;
-  event_name_map["del"] = kDel;
-  event_name_map["rpl"] = kRpl;
-  event_name_map["unknown"] = kUnknown;
+  // the names, in the order of the EventType enum
+  static const char* const EVENT_TYPE_NAMES[NUMBER_OF_EVENT_TYPES] =
+      { "unknown", "snp", "ins", "del", "rpl" };
 
   std::string normalized_input = Utilities::StringToLowerCase(input);
-  Utilities::Require(Utilities::MapContainsKey(event_name_map,
-      normalized_input), "GetEventTypeFromString error: SV type unknown.");
-  return event_name_map[normalized_input];
+  for (int event_type = 0; event_type < NUMBER_OF_EVENT_TYPES; ++event_type) {
+    if (normalized_input == EVENT_TYPE_NAMES[event_type]) {
+      return static_cast<EventType>(event_type);
+    }
+  }
+  Utilities::Require(false, "GetEventTypeFromString error: SV type unknown.");
+  return kUnknown;
 }
 
 
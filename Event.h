@@ -13,25 +13,43 @@
 #define EVENT_H_
 
 #include <string>
-#include <vector>
+
+#include "Span.h"
 
 enum EventType { kUnknown, kSnp, kIns, kDel, kRpl };
+// event types can index arrays of this size
+const int NUMBER_OF_EVENT_TYPES = kRpl + 1;
 
 EventType GetEventTypeFromString(const std::string& input);
 
 class Event {
 public:
-  Event(const std::string& reference, const std::string& alt);
+  Event(const Span& reference, const Span& alt);
   virtual ~Event();
 
   bool HasSingleAltAllele() const;
+  bool HasUnstoredAltAlleles() const;
   int RefSize() const;
   int AltSize() const;
+  int AltSize(int alt_allele) const;
+  int GetNumberOfAltAlleles() const;
+  int GetNumberOfStoredAltAlleles() const;
   EventType GetType() const;
+  EventType GetType(int alt_allele) const;
+
+  // the number of alt alleles of which the size is kept
+  static const int MAX_STORED_ALT_ALLELES = 8;
+  // the size of an alt allele that is not a sequence: '*', the allele of an
+  // overlapping deletion
+  static const int UNSIZED_ALLELE = -1;
 
 private:
-  std::string reference_;
-  std::vector<std::string> alternatives_;
+  // only the sizes of the alleles are kept, not the alleles themselves, so
+  // classifying an event allocates nothing, however long its alleles are;
+  // the alt alleles are numbered from 1, as in the GT field
+  int reference_size_;
+  int number_of_alt_alleles_;
+  int alt_sizes_[MAX_STORED_ALT_ALLELES];
 };
 
 #endif /* EVENT_H_ */
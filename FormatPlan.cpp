@@ -0,0 +1,91 @@
+/*
+ * FormatPlan.cpp
+ *
+ * Tells where the fields the analysis needs (GT and AD) are in the
+ * sample columns of a record, as described by its FORMAT column. The FORMAT
+ * column is parsed only when it differs from that of the previous record,
+ * which in most VCF files it never does.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "FormatPlan.h"
+
+#include <cstring>
+
+namespace {
+
+const char* const FIELD_NAMES[NUMBER_OF_FORMAT_FIELDS] = { "GT", "AD" };
+
+} // namespace
+
+/** Constructor; until a FORMAT column is set, no fields are known. **/
+FormatPlan::FormatPlan() {
+  for (int field = 0; field < NUMBER_OF_FORMAT_FIELDS; ++field) {
+    field_positions_[field] = -1;
+  }
+}
+
+/** Makes the plan describe 'format', if it does not already. An empty
+ * FORMAT column (which may have no text to point to) needs no parsing. **/
+void FormatPlan::SetFormat(const Span& format) {
+  if (format.size() != format_.size() || (!format.empty() &&
+      memcmp(format.begin(), format_.data(), format.size()) != 0)) {
+    Parse(format);
+  }
+}
+
+/** Finds the positions of the needed fields in the colon-separated keys of
+ * the FORMAT column. **/
+void FormatPlan::Parse(const Span& format) {
+  format_.assign(format.begin(), format.end());
+  for (int field = 0; field < NUMBER_OF_FORMAT_FIELDS; ++field) {
+    field_positions_[field] = -1;
+  }
+  fields_at_positions_.clear();
+
+  Span keys = format;
+  for (int position = 0; !keys.empty(); ++position) {
+    Span key = keys.Until(':');
+    keys = keys.After(':');
+    for (int field = 0; field < NUMBER_OF_FORMAT_FIELDS; ++field) {
+      if (key.Equals(FIELD_NAMES[field]) && field_positions_[field] < 0) {
+        field_positions_[field] = position;
+        fields_at_positions_.resize(position + 1, -1);
+        fields_at_positions_[position] = field;
+      }
+    }
+  }
+}
+
+/** Is the field in the FORMAT column at all? **/
+bool FormatPlan::HasField(FormatField field) const {
+  return field_positions_[field] >= 0;
+}
+
+/** Puts the needed fields of a sample column into 'fields' (an array of
+ * NUMBER_OF_FORMAT_FIELDS spans, indexed by FormatField). Fields that are
+ * absent, or dropped from the end of the sample, become empty. The colons
+ * are looked up in 'delimiters', the index of the line the sample is in,
+ * and only up to the last needed field. **/
+void FormatPlan::ExtractFields(const Span& sample,
+    const DelimiterIndex& delimiters, Span* fields) const {
+  for (int field = 0; field < NUMBER_OF_FORMAT_FIELDS; ++field) {
+    fields[field] = Span();
+  }
+  const char* position = sample.begin();
+  const char* end = sample.end();
+  for (size_t key_index = 0; key_index < fields_at_positions_.size();
+      ++key_index) {
+    const char* start_of_value = position;
+    position = delimiters.FindColon(position, end);
+    if (fields_at_positions_[key_index] >= 0) {
+      fields[fields_at_positions_[key_index]] = Span(start_of_value,
+          position);
+    }
+    if (position == end) {
+      break;
+    }
+    ++position; // skip the ':'
+  }
+}
@@ -0,0 +1,44 @@
+/*
+ * FormatPlan.h
+ *
+ * Tells where the fields the analysis needs (GT and AD) are in the
+ * sample columns of a record, as described by its FORMAT column. The FORMAT
+ * column is parsed only when it differs from that of the previous record,
+ * which in most VCF files it never does.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef FORMATPLAN_H_
+#define FORMATPLAN_H_
+
+#include <string>
+#include <vector>
+
+#include "DelimiterIndex.h"
+#include "Span.h"
+
+enum FormatField { kGt, kAd };
+const int NUMBER_OF_FORMAT_FIELDS = kAd + 1;
+
+class FormatPlan {
+public:
+  FormatPlan();
+
+  void ExtractFields(const Span& sample, const DelimiterIndex& delimiters,
+      Span* fields) const;
+  bool HasField(FormatField field) const;
+  void SetFormat(const Span& format);
+
+private:
+  void Parse(const Span& format);
+
+  std::string format_;
+  // the position of each field in the FORMAT column; -1 if it is absent
+  int field_positions_[NUMBER_OF_FORMAT_FIELDS];
+  // for each position in the FORMAT column up to the last needed field:
+  // which field is there, or -1 if it is not needed
+  std::vector<int> fields_at_positions_;
+};
+
+#endif /* FORMATPLAN_H_ */
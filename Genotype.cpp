@@ -12,26 +12,65 @@
 
 #include <cstdlib>
 #include <sstream>
+#include <type_traits>
 
 #include "Utilities.h"
 
+static_assert(std::is_trivially_copyable<Genotype>::value,
+    "Genotype should be copyable with memcpy");
+
 /** formats the genotype neatly for output purposes. **/
 std::ostream& operator<<(std::ostream& os, const Genotype& genotype) {
-  if (genotype.IsUnknown()) {
-    os << ".";
+  std::string genotype_as_string;
+  genotype.AppendTo(&genotype_as_string);
+  os << genotype_as_string;
+  return os;
+}
+
+/** Appends the genotype to 'text' in the output format ("0/1", "0|1" if it is
+ * phased, or "." if the genotype is unknown). **/
+void Genotype::AppendTo(std::string* text) const {
+  if (IsUnknown()) {
+    text->push_back('.');
   }
   else {
-    os << genotype.GetAllele(0);
-    for (int genotypeIndex = 1; genotypeIndex < genotype.GetNumberOfAlleles();
+    Utilities::AppendInteger(GetAllele(0), text);
+    for (int genotypeIndex = 1; genotypeIndex < GetNumberOfAlleles();
         ++genotypeIndex) {
-      os << "/" << genotype.GetAllele(genotypeIndex);
+      text->push_back(m_isPhased ? '|' : '/');
+      Utilities::AppendInteger(GetAllele(genotypeIndex), text);
     }
   }
-  return os;
 }
 
 Genotype::Genotype() {
+  m_ploidy = 0;
   m_isUnknown = true;
+  m_isPhased = false;
+}
+
+/** Returns the genotype that has the given code (see GetCode). **/
+Genotype Genotype::FromCode(int code) {
+  if (code < 0 || code >= NUMBER_OF_CODES) {
+    Utilities::Require(false, "Genotype::FromCode error: invalid code.");
+  }
+  Genotype genotype;
+  if (code == UNKNOWN_CODE) {
+    return genotype;
+  }
+  genotype.m_isUnknown = false;
+  if (code <= NUMBER_OF_CODED_ALLELES) {
+    genotype.m_ploidy = 1;
+    genotype.m_alleles[0] = code - 1;
+  }
+  else {
+    genotype.m_isPhased = (code >= NUMBER_OF_UNPHASED_CODES);
+    int diploid_index = GetUnphasedCode(code) - 1 - NUMBER_OF_CODED_ALLELES;
+    genotype.m_ploidy = 2;
+    genotype.m_alleles[0] = diploid_index / NUMBER_OF_CODED_ALLELES;
+    genotype.m_alleles[1] = diploid_index % NUMBER_OF_CODED_ALLELES;
+  }
+  return genotype;
 }
 
 /** returns the genotype as a string. **/
@@ -52,8 +91,7 @@ void Genotype::AbortWhenUnknown() const {
 /** Is this genotype homozygous reference? **/
 bool Genotype::IsHomRef() const {
   AbortWhenUnknown();
-  for (size_t allele_index = 0; allele_index < m_alleles.size();
-      ++allele_index) {
+  for (int allele_index = 0; allele_index < m_ploidy; ++allele_index) {
     if (m_alleles[allele_index] != 0) {
       return false;
     }
@@ -63,7 +101,13 @@ bool Genotype::IsHomRef() const {
 
 /** is this genotype (certainly) haploid? (unknown does not count). **/
 bool Genotype::IsHaploid() const {
-  return (m_alleles.size() == 1);
+  return (m_ploidy == 1);
+}
+
+/** Is this genotype phased, so that its first allele is on the first
+ * haplotype, and so on? Haploid genotypes are not. **/
+bool Genotype::IsPhased() const {
+  return m_isPhased;
 }
 
 /** sets the genotype to 'unknown' **/
@@ -77,7 +121,7 @@ int Genotype::GetNumberOfAlleles() const {
     return 0;
   }
   else {
-    return m_alleles.size();
+    return m_ploidy;
   }
 }
 
@@ -90,27 +134,109 @@ int Genotype::GetAllele(int alleleIndex) const {
 
 /** Genotype constructor. Takes the genotype as string (so for example "0/1")**/
 Genotype::Genotype(const std::string& genotype_as_string) {
-  //std::cout << "GTstart" << genotype_as_string;
-  std::vector<std::string> alleles = Utilities::Split(genotype_as_string, '/');
-  for (std::vector<std::string>::iterator iter = alleles.begin();
-    iter != alleles.end(); iter++ ) {
+  Parse(Span(genotype_as_string));
+}
+
+/** Genotype constructor. Takes the genotype as a span of text (so for example
+ * "0/1"), usually pointing directly into a line of the VCF file. The usual
+ * genotypes are decoded as a whole; only the others are parsed. **/
+Genotype::Genotype(const Span& genotype) {
+  if (!Decode(genotype)) {
+    Parse(genotype);
+  }
+}
+
+/** Reads the usual genotypes of a joint-called or phased file ("0/1", "0|1",
+ * "./.", ".|.", "1" and "."), each as a single word instead of character by
+ * character. Returns false, and changes nothing, for all other genotypes;
+ * those are left to Parse, which also rejects malformed ones. **/
+bool Genotype::Decode(const Span& genotype) {
+  if (genotype.size() == 3) {
+    unsigned int word = static_cast<unsigned char>(genotype[0]) |
+        static_cast<unsigned char>(genotype[1]) << 8 |
+        static_cast<unsigned char>(genotype[2]) << 16;
+    unsigned int separator = (word >> 8) & 0xFF;
+    if (separator != '/' && separator != '|') {
+      return false;
+    }
+    // the digits '0' and '1' differ only in their lowest bit
+    if ((word & 0xFE00FE) == ('0' | '0' << 16)) {
+      m_alleles[0] = word & 1;
+      m_alleles[1] = (word >> 16) & 1;
+      m_ploidy = 2;
+      m_isUnknown = false;
+      m_isPhased = (separator == '|');
+      return true;
+    }
+    if ((word & 0xFF00FF) == ('.' | '.' << 16)) {
+      m_ploidy = 0;
+      m_isUnknown = true;
+      m_isPhased = false;
+      return true;
+    }
+  }
+  else if (genotype.size() == 1) {
+    if (genotype[0] == '.') {
+      m_ploidy = 0;
+      m_isUnknown = true;
+      m_isPhased = false;
+      return true;
+    }
+    if ((genotype[0] | 1) == '1') {
+      m_alleles[0] = genotype[0] & 1;
+      m_ploidy = 1;
+      m_isUnknown = false;
+      m_isPhased = false;
+      return true;
+    }
+  }
+  return false;
+}
 
-    std::string currentGenotypeAsString = *iter;
-    if (currentGenotypeAsString == ".") {
+/** Reads the alleles, separated by '/' or '|', from the text. The genotype
+ * is phased if it has more than one allele and all separators are '|'. A "."
+ * for any of the alleles makes the genotype unknown; an allele that is not a
+ * number aborts the program, just like a genotype with more than MAX_PLOIDY
+ * alleles. **/
+void Genotype::Parse(const Span& genotype) {
+  m_ploidy = 0;
+  m_isUnknown = false;
+  m_isPhased = false;
+  bool are_all_separators_phased = true;
+  const char* position = genotype.begin();
+  const char* end = genotype.end();
+  while (true) {
+    const char* start_of_allele = position;
+    while (position != end && *position != '/' && *position != '|') {
+      ++position;
+    }
+    Span allele(start_of_allele, position);
+    if (allele.size() == 1 && allele[0] == '.') {
       SetToUnknown();
       return;
     }
-    if (Utilities::isPositiveInteger(currentGenotypeAsString)) {
-      m_alleles.push_back(atoi(currentGenotypeAsString.c_str()));
+    bool is_number = !allele.empty() && (allele[0] != '0' ||
+        allele.size() == 1);
+    int value = 0;
+    for (const char* digit = allele.begin(); is_number && digit != allele.end();
+        ++digit) {
+      is_number = (*digit >= '0' && *digit <= '9');
+      value = 10 * value + (*digit - '0');
+      is_number = is_number && (value <= MAX_ALLELE);
     }
-    else {
+    if (!is_number || m_ploidy == MAX_PLOIDY) {
       Utilities::Require(false, "Genotype constructor error: genotype " +
-          genotype_as_string +" is unknown!");
+          genotype.ToString() +" is unknown!");
+    }
+    m_alleles[m_ploidy++] = value;
+    if (position == end) {
+      break;
     }
+    are_all_separators_phased = are_all_separators_phased &&
+        (*position == '|');
+    ++position; // skip the separator
   }
-  // if you get here, everything is normal
-  m_isUnknown = false;
-  //std::cout << "GTend";
+  m_isPhased = (m_ploidy > 1 && are_all_separators_phased);
 }
 
 /** Does this genotype have a certain allele? **/
@@ -118,7 +244,7 @@ bool Genotype::HasAllele(int allele) const {
   if (IsUnknown()) {
     Utilities::Require(false, "Genotype::hasAllele error: genotype is unknown!\n");
   }
-  int numberOfAlleles = m_alleles.size();
+  int numberOfAlleles = m_ploidy;
   for (int alleleIndex = 0; alleleIndex < numberOfAlleles; alleleIndex++) {
     if (m_alleles[alleleIndex] == allele) {
       return true;
@@ -131,7 +257,3 @@ bool Genotype::HasAllele(int allele) const {
 bool Genotype::IsUnknown() const {
   return m_isUnknown;
 }
-
-Genotype::~Genotype() {
-  m_alleles.clear();
-}
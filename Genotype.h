@@ -13,33 +13,89 @@
 
 #include <iostream>
 #include <string>
-#include <vector>
+
+#include "Span.h"
 
 /** 'Genotype' stores a genotype as a list of numbers. Usually 2, can be one
-* (Y chromosome genotypes, for example). Can be 0, 1, 0/0, 0/1, 0/2, 1/2, etc. **/
+* (Y chromosome genotypes, for example). Can be 0, 1, 0/0, 0/1, 0/2, 1/2, etc.
+* A genotype of which the alleles are separated by '|' (0|1) is phased: the
+* order of its alleles is that of the haplotypes they are on.
+* The alleles are stored inside the object itself, so a Genotype is trivially
+* copyable and never allocates memory. **/
 class Genotype {
   friend std::ostream& operator<<(std::ostream& os, const Genotype& genotype);
 
 public:
   Genotype(const std::string& genotypeAsString);
+  Genotype(const Span& genotype);
   Genotype();
-  ~Genotype();
 
+  static Genotype FromCode(int code);
+  static int GetUnphasedCode(int code);
+  void AppendTo(std::string* text) const;
   std::string AsString() const;
   int GetAllele(int alleleIndex) const;
+  int GetCode() const;
   bool IsHaploid() const;
+  bool IsPhased() const;
   bool HasAllele(int allele) const;
   int GetNumberOfAlleles() const;
   bool IsUnknown() const;
   bool IsHomRef() const;
   void SetToUnknown();
 
+  static const int MAX_PLOIDY = 4;
+  static const int MAX_ALLELE = 65535;
+
+  // Small genotypes get a code: 0 for unknown, then the haploid and diploid
+  // genotypes with alleles up to MAX_CODED_ALLELE, then the same diploid
+  // genotypes phased (PHASED_CODE_OFFSET further on). Other genotypes have
+  // code NO_CODE.
+  static const int MAX_CODED_ALLELE = 1;
+  static const int NUMBER_OF_CODED_ALLELES = MAX_CODED_ALLELE + 1;
+  static const int NUMBER_OF_UNPHASED_CODES = 1 + NUMBER_OF_CODED_ALLELES +
+      NUMBER_OF_CODED_ALLELES * NUMBER_OF_CODED_ALLELES;
+  static const int PHASED_CODE_OFFSET =
+      NUMBER_OF_CODED_ALLELES * NUMBER_OF_CODED_ALLELES;
+  static const int NUMBER_OF_CODES = NUMBER_OF_UNPHASED_CODES +
+      PHASED_CODE_OFFSET;
+  static const int UNKNOWN_CODE = 0;
+  static const int NO_CODE = -1;
+
 private:
 
   void AbortWhenUnknown() const;
+  bool Decode(const Span& genotype);
+  void Parse(const Span& genotype);
 
-  std::vector<int> m_alleles;
+  unsigned short m_alleles[MAX_PLOIDY];
+  unsigned char m_ploidy;
   bool m_isUnknown;
+  bool m_isPhased;
 };
 
+/** Returns the code of this genotype (see NUMBER_OF_CODES), or NO_CODE.
+ * Defined here as it is called for every sample of every trio. **/
+inline int Genotype::GetCode() const {
+  if (m_isUnknown) {
+    return UNKNOWN_CODE;
+  }
+  if (m_ploidy == 1 && m_alleles[0] <= MAX_CODED_ALLELE) {
+    return 1 + m_alleles[0];
+  }
+  if (m_ploidy == 2 && m_alleles[0] <= MAX_CODED_ALLELE &&
+      m_alleles[1] <= MAX_CODED_ALLELE) {
+    return 1 + NUMBER_OF_CODED_ALLELES +
+        NUMBER_OF_CODED_ALLELES * m_alleles[0] + m_alleles[1] +
+        (m_isPhased ? PHASED_CODE_OFFSET : 0);
+  }
+  return NO_CODE;
+}
+
+/** Returns the code of the unphased form of the genotype that has 'code'
+ * (the code itself if that is not of a phased genotype). **/
+inline int Genotype::GetUnphasedCode(int code) {
+  return (code >= NUMBER_OF_UNPHASED_CODES) ? code - PHASED_CODE_OFFSET : code;
+}
+
 #endif /* GENOTYPE_H_ */
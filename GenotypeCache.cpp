@@ -0,0 +1,290 @@
+/*
+ * GenotypeCache.cpp
+ *
+ * A binary file with the parsed contents of a VCF file, so that repeated
+ * analyses of the same callset (with other types, sizes or confidences) do
+ * not tokenize the text again. The file is organized in columns: per record
+ * the fixed columns as text (for the output file) and the spans of REF and
+ * ALT in them; per sample a genotype code byte and the support counts. A
+ * later run maps the file into memory and reads the records from it
+ * directly. The numbers are stored in the byte order of the machine that
+ * wrote the file.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "GenotypeCache.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Genotype.h"
+#include "Support.h"
+#include "Utilities.h"
+
+const char GenotypeCache::MAGIC[8] = { 'M', 'E', 'N', 'D', 'G', 'C', '0',
+    '3' };
+
+/** Constructor; no file opened yet. **/
+GenotypeCache::GenotypeCache() : mapped_data_(NULL), mapped_size_(0),
+    next_record_(0), next_uncoded_genotype_(0), first_sample_(0),
+    first_count_(0), first_uncoded_genotype_(0) {
+  memset(&header_, 0, sizeof(header_));
+}
+
+/** Destructor **/
+GenotypeCache::~GenotypeCache() {
+  if (mapped_data_ != NULL) {
+    munmap(mapped_data_, mapped_size_);
+  }
+}
+
+/** Identifies the input file by its device, inode, size and modification
+ * time. Returns false, with all of them 0, if it is not a regular file: a
+ * pipe cannot be told apart from another one. **/
+bool GenotypeCache::IdentifyInputFile(const std::string& name_of_input_file,
+    InputFileIdentity* input_file) {
+  memset(input_file, 0, sizeof(*input_file));
+  struct stat file_status;
+  if (stat(name_of_input_file.c_str(), &file_status) != 0 ||
+      !S_ISREG(file_status.st_mode)) {
+    return false;
+  }
+  input_file->device = file_status.st_dev;
+  input_file->inode = file_status.st_ino;
+  input_file->size = file_status.st_size;
+  input_file->modification_seconds = file_status.st_mtim.tv_sec;
+  input_file->modification_nanoseconds = file_status.st_mtim.tv_nsec;
+  return true;
+}
+
+/** Maps the cache file into memory. Returns false if the file does not
+ * exist; aborts if it is not a cache file, or if it is the cache of another
+ * input file, of one that has changed since (see IdentifyInputFile), or
+ * was parsed with another 'pindel' setting. **/
+bool GenotypeCache::Open(const std::string& name_of_cache_file,
+    const InputFileIdentity& input_file, bool is_pindel) {
+  int file_descriptor = open(name_of_cache_file.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    return false;
+  }
+  struct stat file_status;
+  bool is_mapped = fstat(file_descriptor, &file_status) == 0 &&
+      S_ISREG(file_status.st_mode) &&
+      static_cast<size_t>(file_status.st_size) >= sizeof(header_);
+  if (is_mapped) {
+    void* mapping = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE,
+        file_descriptor, 0);
+    is_mapped = (mapping != MAP_FAILED);
+    if (is_mapped) {
+      madvise(mapping, file_status.st_size, MADV_SEQUENTIAL);
+      mapped_data_ = static_cast<char*>(mapping);
+      mapped_size_ = file_status.st_size;
+    }
+  }
+  close(file_descriptor);
+  Utilities::Require(is_mapped && memcmp(mapped_data_, MAGIC,
+      sizeof(MAGIC)) == 0, "GenotypeCache error: '" + name_of_cache_file +
+      "' is not a cache file, or one of an older version; remove it to "
+      "write a new cache.");
+  memcpy(&header_, mapped_data_, sizeof(header_));
+  const InputFileIdentity& cached_file = header_.input_file;
+  Utilities::Require(cached_file.device == input_file.device &&
+      cached_file.inode == input_file.inode &&
+      cached_file.size == input_file.size &&
+      cached_file.modification_seconds == input_file.modification_seconds &&
+      cached_file.modification_nanoseconds ==
+      input_file.modification_nanoseconds &&
+      (header_.is_pindel != 0) == is_pindel, "GenotypeCache error: '" +
+      name_of_cache_file + "' is the cache of another input file, of this "
+      "one before it changed, or of this one with(out) 'pindel'; remove it "
+      "to write a new cache.");
+
+  bool is_valid = true;
+  for (int section = 0; section < NUMBER_OF_CACHE_SECTIONS; ++section) {
+    is_valid = is_valid && header_.section_offsets[section] % 8 == 0 &&
+        header_.section_offsets[section] <= mapped_size_ &&
+        header_.section_sizes[section] <=
+        mapped_size_ - header_.section_offsets[section];
+  }
+  unsigned long long number_of_records = header_.number_of_records;
+  unsigned long long size_of_offsets = 8 * (number_of_records + 1);
+  is_valid = is_valid && number_of_records < mapped_size_ &&
+      header_.section_sizes[kTextOffsetSection] == size_of_offsets &&
+      header_.section_sizes[kSampleOffsetSection] == size_of_offsets &&
+      header_.section_sizes[kCountOffsetSection] == size_of_offsets &&
+      header_.section_sizes[kAlleleSpanSection] == 16 * number_of_records;
+  if (is_valid) {
+    is_valid = AreRecordsValid();
+  }
+  Utilities::Require(is_valid, "GenotypeCache error: cache file '" +
+      name_of_cache_file + "' is damaged.");
+  Rewind();
+  return true;
+}
+
+/** Checks that the sections agree with each other, so that the records can
+ * be read without checks. **/
+bool GenotypeCache::AreRecordsValid() const {
+  const unsigned long long* text_offsets =
+      reinterpret_cast<const unsigned long long*>(
+      GetSection(kTextOffsetSection));
+  const unsigned int* spans = reinterpret_cast<const unsigned int*>(
+      GetSection(kAlleleSpanSection));
+  const unsigned long long* sample_offsets =
+      reinterpret_cast<const unsigned long long*>(
+      GetSection(kSampleOffsetSection));
+  const unsigned long long* count_offsets =
+      reinterpret_cast<const unsigned long long*>(
+      GetSection(kCountOffsetSection));
+  const unsigned char* codes = reinterpret_cast<const unsigned char*>(
+      GetSection(kGenotypeCodeSection));
+  const unsigned char* numbers_of_counts =
+      reinterpret_cast<const unsigned char*>(
+      GetSection(kNumberOfCountsSection));
+  const char* counts = GetSection(kCountSection);
+  unsigned long long number_of_records = header_.number_of_records;
+  if (text_offsets[0] != 0 || sample_offsets[0] != 0 ||
+      count_offsets[0] != 0 ||
+      text_offsets[number_of_records] != header_.section_sizes[kTextSection] ||
+      sample_offsets[number_of_records] !=
+      header_.section_sizes[kGenotypeCodeSection] ||
+      sample_offsets[number_of_records] !=
+      header_.section_sizes[kNumberOfCountsSection] ||
+      count_offsets[number_of_records] !=
+      header_.section_sizes[kCountSection]) {
+    return false;
+  }
+  unsigned long long number_of_uncoded_genotypes = 0;
+  for (unsigned long long record = 0; record < number_of_records; ++record) {
+    if (text_offsets[record] > text_offsets[record + 1] ||
+        sample_offsets[record] > sample_offsets[record + 1] ||
+        count_offsets[record] > count_offsets[record + 1]) {
+      return false;
+    }
+    unsigned long long size_of_text =
+        text_offsets[record + 1] - text_offsets[record];
+    const unsigned int* record_spans = spans + 4 * record;
+    if (record_spans[0] + static_cast<unsigned long long>(record_spans[1]) >
+        size_of_text ||
+        record_spans[2] + static_cast<unsigned long long>(record_spans[3]) >
+        size_of_text) {
+      return false;
+    }
+    // every count ends in a byte without the high bit
+    unsigned long long number_of_counts = 0;
+    for (unsigned long long sample = sample_offsets[record];
+        sample < sample_offsets[record + 1]; ++sample) {
+      if (numbers_of_counts[sample] > Support::MAX_ALLELES) {
+        return false;
+      }
+      number_of_counts += numbers_of_counts[sample];
+      number_of_uncoded_genotypes += (codes[sample] == UNCODED_GENOTYPE);
+    }
+    unsigned long long number_of_count_ends = 0;
+    for (unsigned long long index = count_offsets[record];
+        index < count_offsets[record + 1]; ++index) {
+      number_of_count_ends += (counts[index] & 0x80) == 0;
+    }
+    if (number_of_count_ends != number_of_counts ||
+        (count_offsets[record + 1] > count_offsets[record] &&
+        (counts[count_offsets[record + 1] - 1] & 0x80) != 0)) {
+      return false;
+    }
+  }
+  return header_.section_sizes[kUncodedGenotypeSection] ==
+      sizeof(Genotype) * number_of_uncoded_genotypes;
+}
+
+/** Returns the start of a section of the file. **/
+const char* GenotypeCache::GetSection(GenotypeCacheSection section) const {
+  return mapped_data_ + header_.section_offsets[section];
+}
+
+/** Returns the header lines of the VCF file, each ending in a newline. **/
+Span GenotypeCache::GetHeaderLines() const {
+  return Span(GetSection(kHeaderSection),
+      header_.section_sizes[kHeaderSection]);
+}
+
+/** Reads the fixed columns of the next record; returns false if all
+ * records have been read. The spans point into the mapped file. The samples
+ * are only read by ReadSamples, so records that are filtered out cost
+ * little. **/
+bool GenotypeCache::Next(CachedRecord* record) {
+  if (next_record_ == header_.number_of_records) {
+    return false;
+  }
+  const unsigned long long* text_offsets =
+      reinterpret_cast<const unsigned long long*>(
+      GetSection(kTextOffsetSection)) + next_record_;
+  const unsigned int* spans = reinterpret_cast<const unsigned int*>(
+      GetSection(kAlleleSpanSection)) + 4 * next_record_;
+  const unsigned long long* sample_offsets =
+      reinterpret_cast<const unsigned long long*>(
+      GetSection(kSampleOffsetSection)) + next_record_;
+  const unsigned long long* count_offsets =
+      reinterpret_cast<const unsigned long long*>(
+      GetSection(kCountOffsetSection)) + next_record_;
+  ++next_record_;
+
+  const char* text = GetSection(kTextSection);
+  record->fixed_columns = Span(text + text_offsets[0],
+      text + text_offsets[1]);
+  record->reference = Span(record->fixed_columns.begin() + spans[0],
+      spans[1]);
+  record->alt = Span(record->fixed_columns.begin() + spans[2], spans[3]);
+  record->number_of_samples = sample_offsets[1] - sample_offsets[0];
+  record->results.clear();
+
+  first_sample_ = sample_offsets[0];
+  first_count_ = count_offsets[0];
+  first_uncoded_genotype_ = next_uncoded_genotype_;
+  const unsigned char* codes = reinterpret_cast<const unsigned char*>(
+      GetSection(kGenotypeCodeSection));
+  for (unsigned long long sample = sample_offsets[0];
+      sample < sample_offsets[1]; ++sample) {
+    next_uncoded_genotype_ += (codes[sample] == UNCODED_GENOTYPE);
+  }
+  return true;
+}
+
+/** Reads the samples of the record that Next read last into 'record'. **/
+void GenotypeCache::ReadSamples(CachedRecord* record) const {
+  const unsigned char* codes = reinterpret_cast<const unsigned char*>(
+      GetSection(kGenotypeCodeSection));
+  const unsigned char* numbers_of_counts =
+      reinterpret_cast<const unsigned char*>(
+      GetSection(kNumberOfCountsSection));
+  const char* uncoded_genotype = GetSection(kUncodedGenotypeSection) +
+      sizeof(Genotype) * first_uncoded_genotype_;
+  const char* position = GetSection(kCountSection) + first_count_;
+  record->results.clear();
+  for (unsigned long long sample = first_sample_;
+      sample < first_sample_ + record->number_of_samples; ++sample) {
+    Genotype genotype;
+    if (codes[sample] != UNCODED_GENOTYPE) {
+      genotype = Genotype::FromCode(codes[sample]);
+    }
+    else {
+      memcpy(&genotype, uncoded_genotype, sizeof(genotype));
+      uncoded_genotype += sizeof(genotype);
+    }
+    int counts[Support::MAX_ALLELES];
+    for (int allele = 0; allele < numbers_of_counts[sample]; ++allele) {
+      counts[allele] = Utilities::ReadCompactCount(&position);
+    }
+    record->results.emplace_back(genotype,
+        Support(counts, numbers_of_counts[sample]));
+  }
+}
+
+/** Goes back to the first record, to read the records (again). **/
+void GenotypeCache::Rewind() {
+  next_record_ = 0;
+  next_uncoded_genotype_ = 0;
+}
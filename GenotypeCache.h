@@ -0,0 +1,106 @@
+/*
+ * GenotypeCache.h
+ *
+ * A binary file with the parsed contents of a VCF file, so that repeated
+ * analyses of the same callset (with other types, sizes or confidences) do
+ * not tokenize the text again. The file is organized in columns: per record
+ * the fixed columns as text (for the output file) and the spans of REF and
+ * ALT in them; per sample a genotype code byte and the support counts. A
+ * later run maps the file into memory and reads the records from it
+ * directly. The numbers are stored in the byte order of the machine that
+ * wrote the file.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef GENOTYPECACHE_H_
+#define GENOTYPECACHE_H_
+
+#include <string>
+
+#include "RecordCache.h"
+#include "Span.h"
+
+enum GenotypeCacheSection {
+  // the header lines of the VCF file, each ending in a newline
+  kHeaderSection,
+  // CHROM up to and including INFO of all records, one after the other
+  kTextSection,
+  // per record (and once more at the end) the offset of its text (uint64)
+  kTextOffsetSection,
+  // per record the offsets and sizes of REF and ALT in its text (4 uint32)
+  kAlleleSpanSection,
+  // per record (and once more at the end) the index of its first sample
+  // (uint64)
+  kSampleOffsetSection,
+  // per record (and once more at the end) the offset of its first count in
+  // kCountSection (uint64)
+  kCountOffsetSection,
+  // per sample the code of its genotype (uint8), or UNCODED_GENOTYPE
+  kGenotypeCodeSection,
+  // the genotypes without a code, as they are in memory
+  kUncodedGenotypeSection,
+  // per sample the number of support counts (uint8)
+  kNumberOfCountsSection,
+  // the support counts of all samples, each in one or a few bytes (see
+  // Utilities::AppendCompactCount)
+  kCountSection
+};
+const int NUMBER_OF_CACHE_SECTIONS = kCountSection + 1;
+
+// which file, and which version of it, a cache was written of; all 0 if
+// the input is not a regular file (a pipe)
+struct InputFileIdentity {
+  unsigned long long device;
+  unsigned long long inode;
+  unsigned long long size;
+  unsigned long long modification_seconds;
+  unsigned long long modification_nanoseconds;
+};
+
+// the start of the file; every section starts at a multiple of 8 bytes
+struct GenotypeCacheHeader {
+  char magic[8];
+  // the input file of which this is the cache, and how it was parsed
+  InputFileIdentity input_file;
+  unsigned long long is_pindel;
+  unsigned long long number_of_records;
+  unsigned long long section_offsets[NUMBER_OF_CACHE_SECTIONS];
+  unsigned long long section_sizes[NUMBER_OF_CACHE_SECTIONS];
+};
+
+class GenotypeCache {
+public:
+  GenotypeCache();
+  virtual ~GenotypeCache();
+
+  bool Open(const std::string& name_of_cache_file,
+      const InputFileIdentity& input_file, bool is_pindel);
+  Span GetHeaderLines() const;
+  bool Next(CachedRecord* record);
+  void ReadSamples(CachedRecord* record) const;
+  void Rewind();
+
+  static bool IdentifyInputFile(const std::string& name_of_input_file,
+      InputFileIdentity* input_file);
+
+  static const char MAGIC[8];
+  static const unsigned char UNCODED_GENOTYPE = 0xFF;
+
+private:
+  bool AreRecordsValid() const;
+  const char* GetSection(GenotypeCacheSection section) const;
+
+  char* mapped_data_;
+  size_t mapped_size_;
+  GenotypeCacheHeader header_;
+  // the index of the next record, and of its first uncoded genotype
+  unsigned long long next_record_;
+  unsigned long long next_uncoded_genotype_;
+  // where the samples of the record read last start
+  unsigned long long first_sample_;
+  unsigned long long first_count_;
+  unsigned long long first_uncoded_genotype_;
+};
+
+#endif /* GENOTYPECACHE_H_ */
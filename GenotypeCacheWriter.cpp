@@ -0,0 +1,165 @@
+/*
+ * GenotypeCacheWriter.cpp
+ *
+ * Writes a cache file (see GenotypeCache) while the VCF file is read. Every
+ * section of the cache grows in a temporary file of its own; when all
+ * records have been added, the sections are copied one after the other
+ * into the cache file.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "GenotypeCacheWriter.h"
+
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Genotype.h"
+#include "Support.h"
+#include "Utilities.h"
+
+/** Constructor; opens the temporary files of the sections. **/
+GenotypeCacheWriter::GenotypeCacheWriter(
+    const std::string& name_of_cache_file,
+    const InputFileIdentity& input_file, bool is_pindel) :
+    name_of_cache_file_(name_of_cache_file) {
+  memset(&header_, 0, sizeof(header_));
+  memcpy(header_.magic, GenotypeCache::MAGIC, sizeof(header_.magic));
+  header_.input_file = input_file;
+  header_.is_pindel = is_pindel ? 1 : 0;
+  for (int section = 0; section < NUMBER_OF_CACHE_SECTIONS; ++section) {
+    sections_[section].file = tmpfile();
+    Utilities::Require(sections_[section].file != NULL,
+        "GenotypeCacheWriter error: cannot create a temporary file.");
+  }
+  unsigned long long zero = 0;
+  Append(kTextOffsetSection, &zero, sizeof(zero));
+  Append(kSampleOffsetSection, &zero, sizeof(zero));
+  Append(kCountOffsetSection, &zero, sizeof(zero));
+}
+
+/** Destructor **/
+GenotypeCacheWriter::~GenotypeCacheWriter() {
+  for (int section = 0; section < NUMBER_OF_CACHE_SECTIONS; ++section) {
+    fclose(sections_[section].file);
+  }
+}
+
+/** Appends bytes to a section; writes them to its temporary file once there
+ * is a block of them. **/
+void GenotypeCacheWriter::Append(GenotypeCacheSection section,
+    const void* data, size_t number_of_bytes) {
+  Section& target = sections_[section];
+  target.buffer.append(static_cast<const char*>(data), number_of_bytes);
+  target.size += number_of_bytes;
+  if (target.buffer.size() >= BLOCK_SIZE) {
+    Utilities::Require(fwrite(target.buffer.data(), 1, target.buffer.size(),
+        target.file) == target.buffer.size(),
+        "GenotypeCacheWriter error: cannot write to a temporary file.");
+    target.buffer.clear();
+  }
+}
+
+/** Adds a header line of the VCF file. **/
+void GenotypeCacheWriter::AddHeaderLine(const Span& line) {
+  Append(kHeaderSection, line.begin(), line.size());
+  Append(kHeaderSection, "\n", 1);
+}
+
+/** Adds a record, which should hold all of its samples. **/
+void GenotypeCacheWriter::Add(const CachedRecord& record) {
+  Utilities::Require(record.results.size() ==
+      static_cast<size_t>(record.number_of_samples),
+      "GenotypeCacheWriter error: a record lacks samples.");
+  Append(kTextSection, record.fixed_columns.begin(),
+      record.fixed_columns.size());
+  unsigned long long end_of_text = sections_[kTextSection].size;
+  Append(kTextOffsetSection, &end_of_text, sizeof(end_of_text));
+  unsigned int spans[4] = {
+      static_cast<unsigned int>(record.reference.begin() -
+          record.fixed_columns.begin()),
+      static_cast<unsigned int>(record.reference.size()),
+      static_cast<unsigned int>(record.alt.begin() -
+          record.fixed_columns.begin()),
+      static_cast<unsigned int>(record.alt.size()) };
+  Append(kAlleleSpanSection, spans, sizeof(spans));
+
+  for (size_t index = 0; index < record.results.size(); ++index) {
+    const Genotype& genotype = record.results[index].GetGenotype();
+    int code = genotype.GetCode();
+    unsigned char code_byte = (code != Genotype::NO_CODE) ?
+        static_cast<unsigned char>(code) : GenotypeCache::UNCODED_GENOTYPE;
+    Append(kGenotypeCodeSection, &code_byte, 1);
+    if (code == Genotype::NO_CODE) {
+      Append(kUncodedGenotypeSection, &genotype, sizeof(genotype));
+    }
+    const Support& support = record.results[index].GetSupport();
+    unsigned char number_of_counts = support.GetNumberOfAlleles();
+    Append(kNumberOfCountsSection, &number_of_counts, 1);
+    for (int allele = 0; allele < support.GetNumberOfAlleles(); ++allele) {
+      Utilities::AppendCompactCount(support.GetCount(allele),
+          &encoded_counts_);
+    }
+  }
+  Append(kCountSection, encoded_counts_.data(), encoded_counts_.size());
+  encoded_counts_.clear();
+  unsigned long long end_of_samples = sections_[kGenotypeCodeSection].size;
+  Append(kSampleOffsetSection, &end_of_samples, sizeof(end_of_samples));
+  unsigned long long end_of_counts = sections_[kCountSection].size;
+  Append(kCountOffsetSection, &end_of_counts, sizeof(end_of_counts));
+  ++header_.number_of_records;
+}
+
+/** Copies a section from its temporary file to the end of the cache file,
+ * which is first padded to a multiple of 8 bytes. **/
+void GenotypeCacheWriter::WriteSection(GenotypeCacheSection section,
+    FILE* cache_file) {
+  Section& source = sections_[section];
+  bool is_written = source.buffer.empty() || fwrite(source.buffer.data(), 1,
+      source.buffer.size(), source.file) == source.buffer.size();
+  source.buffer.clear();
+  is_written = is_written && fflush(source.file) == 0;
+  rewind(source.file);
+
+  long offset = ftell(cache_file);
+  const char padding[8] = { 0 };
+  size_t size_of_padding = (8 - offset % 8) % 8;
+  is_written = is_written && offset >= 0 && fwrite(padding, 1,
+      size_of_padding, cache_file) == size_of_padding;
+  offset += size_of_padding;
+  header_.section_offsets[section] = offset;
+  header_.section_sizes[section] = source.size;
+  std::vector<char> block(BLOCK_SIZE);
+  size_t bytes_read;
+  while (is_written &&
+      (bytes_read = fread(&block[0], 1, block.size(), source.file)) > 0) {
+    is_written = fwrite(&block[0], 1, bytes_read, cache_file) == bytes_read;
+  }
+  Utilities::Require(is_written, "GenotypeCacheWriter error: cannot write "
+      "cache file '" + name_of_cache_file_ + "'.");
+}
+
+/** Writes the cache file. It is written under a temporary name first, so
+ * that an interrupted run does not leave a partial cache behind. **/
+void GenotypeCacheWriter::Finish() {
+  std::string name_of_temporary_file = name_of_cache_file_ + ".tmp";
+  FILE* cache_file = fopen(name_of_temporary_file.c_str(), "wb");
+  Utilities::Require(cache_file != NULL, "GenotypeCacheWriter error: "
+      "cannot write cache file '" + name_of_cache_file_ + "'.");
+  // the header is written again once the sections are in place
+  bool is_written =
+      fwrite(&header_, 1, sizeof(header_), cache_file) == sizeof(header_);
+  for (int section = 0; is_written && section < NUMBER_OF_CACHE_SECTIONS;
+      ++section) {
+    WriteSection(static_cast<GenotypeCacheSection>(section), cache_file);
+  }
+  is_written = is_written && fseek(cache_file, 0, SEEK_SET) == 0 &&
+      fwrite(&header_, 1, sizeof(header_), cache_file) == sizeof(header_) &&
+      fflush(cache_file) == 0 && fsync(fileno(cache_file)) == 0;
+  is_written = (fclose(cache_file) == 0) && is_written;
+  Utilities::Require(is_written && rename(name_of_temporary_file.c_str(),
+      name_of_cache_file_.c_str()) == 0, "GenotypeCacheWriter error: "
+      "cannot write cache file '" + name_of_cache_file_ + "'.");
+}
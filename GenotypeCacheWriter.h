@@ -0,0 +1,54 @@
+/*
+ * GenotypeCacheWriter.h
+ *
+ * Writes a cache file (see GenotypeCache) while the VCF file is read. Every
+ * section of the cache grows in a temporary file of its own; when all
+ * records have been added, the sections are copied one after the other
+ * into the cache file.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef GENOTYPECACHEWRITER_H_
+#define GENOTYPECACHEWRITER_H_
+
+#include <cstdio>
+#include <string>
+
+#include "GenotypeCache.h"
+#include "RecordCache.h"
+#include "Span.h"
+
+class GenotypeCacheWriter {
+public:
+  GenotypeCacheWriter(const std::string& name_of_cache_file,
+      const InputFileIdentity& input_file, bool is_pindel);
+  virtual ~GenotypeCacheWriter();
+
+  void Add(const CachedRecord& record);
+  void AddHeaderLine(const Span& line);
+  void Finish();
+
+private:
+  struct Section {
+    Section() : file(NULL), size(0) {}
+    FILE* file;
+    // the end of the section, not yet written to 'file'
+    std::string buffer;
+    unsigned long long size;
+  };
+
+  void Append(GenotypeCacheSection section, const void* data,
+      size_t number_of_bytes);
+  void WriteSection(GenotypeCacheSection section, FILE* cache_file);
+
+  static const size_t BLOCK_SIZE = 1 << 20;
+
+  std::string name_of_cache_file_;
+  GenotypeCacheHeader header_;
+  Section sections_[NUMBER_OF_CACHE_SECTIONS];
+  // the counts of the record being added, encoded
+  std::string encoded_counts_;
+};
+
+#endif /* GENOTYPECACHEWRITER_H_ */
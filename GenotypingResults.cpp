@@ -17,11 +17,11 @@
 #include "Utilities.h"
 
 std::ostream& operator<<(std::ostream& os,
-    GenotypingResults genotyping_results) {
+    const GenotypingResults& genotyping_results) {
 
   os << genotyping_results.GetGenotype();
 
-  Support support = genotyping_results.GetSupport();
+  const Support& support = genotyping_results.GetSupport();
   //if (!support.IndicatesUnknownGenotype()) {
     os << ":";
     os << support;
@@ -29,33 +29,93 @@ std::ostream& operator<<(std::ostream& os,
   return os;
 }
 
-/** Constructor. Note; while pointers may be more elegant for genotype and
- * support, they gave quite a headache **/
-GenotypingResults::GenotypingResults(const std::string& genotyping_data_as_string,
+/** Constructor. Takes the fields that 'format_plan' points out, found with
+ * the delimiter index of the line the sample is in: the genotype from GT
+ * (unknown if there is none) and the support from AD (no support if there
+ * is none). Pindel reports unknown genotypes through the support. Note; while pointers may be more elegant for genotype
+ * and support, they gave quite a headache **/
+GenotypingResults::GenotypingResults(const Span& genotyping_data,
+    const DelimiterIndex& delimiters, const FormatPlan& format_plan,
     bool is_pindel) {
+  Span fields[NUMBER_OF_FORMAT_FIELDS];
+  format_plan.ExtractFields(genotyping_data, delimiters, fields);
+  genotype_ = fields[kGt].empty() ? Genotype(Span(".", 1)) :
+      Genotype(fields[kGt]);
+  support_ = format_plan.HasField(kAd) ?
+      Support(fields[kAd]) : Support::NoSupport();
+  if (is_pindel && support_.IndicatesUnknownGenotype()) {
+    genotype_.SetToUnknown();
+  }
+}
+
+/** Constructor. Takes a genotype and support that have been parsed
+ * before. **/
+GenotypingResults::GenotypingResults(const Genotype& genotype,
+    const Support& support) : genotype_(genotype), support_(support) {
+}
 
+/** Appends the genotype and the support, separated by a colon, to 'text'.
+ * This is what goes into the sample columns of the output file. **/
+void GenotypingResults::AppendTo(std::string* text) const {
+  genotype_.AppendTo(text);
+  text->push_back(':');
+  support_.AppendTo(text);
+}
+
+/** Destructor **/
+GenotypingResults::~GenotypingResults() {
+}
 
-  size_t colon_position = genotyping_data_as_string.find_first_of(':');
-  std::string basic_genotype_string =
-      genotyping_data_as_string.substr(0, colon_position);
-  Genotype new_genotype(basic_genotype_string);
-  genotype_ = new_genotype;
-  if (is_pindel) {
-    std::string extra_genotyping_info =
-        genotyping_data_as_string.substr(colon_position + 1);
-    Support new_support(extra_genotyping_info);
-    support_ = new_support;
-    if (support_.IndicatesUnknownGenotype()) {
-      genotype_.SetToUnknown();
+/** Returns the alt allele of the event (1 for the first) that the call is
+ * about, which is 1 unless the event is multi-allelic. Of a multi-allelic
+ * event, it is the alt allele in the genotype with the most reads, or, if
+ * the genotype has none (such as 0/0 or ./.), the alt allele of the event
+ * with the most reads; the lowest one on a tie. **/
+int GenotypingResults::GetAltAllele(const Event& event) const {
+  int number_of_alt_alleles = event.GetNumberOfAltAlleles();
+  if (number_of_alt_alleles == 1) {
+    return 1;
+  }
+  int number_of_counts = support_.GetNumberOfAlleles();
+  int best_allele = 0;
+  int best_count = 0;
+  int first_pass = genotype_.IsUnknown() ? 1 : 0;
+  for (int pass = first_pass; pass < 2 && best_allele == 0; ++pass) {
+    // the first pass only considers the alleles of the genotype
+    for (int allele = 1; allele <= number_of_alt_alleles; ++allele) {
+      if (pass == 0 && !genotype_.HasAllele(allele)) {
+        continue;
+      }
+      int count = (allele < number_of_counts) ? support_.GetCount(allele) : 0;
+      if (best_allele == 0 || count > best_count) {
+        best_allele = allele;
+        best_count = count;
+      }
     }
   }
-  else {
-    support_ = Support("");
+  return best_allele;
+}
+
+/** Returns the VAF of the alt allele that the call is about (see
+ * GetAltAllele); -1 if it is not known. **/
+double GenotypingResults::GetVaf(const Event& event) const {
+  return GetVaf(event, GetAltAllele(event));
+}
+
+/** Returns the VAF of one of the alt alleles of the event (1 for the
+ * first); -1 if it is not known, which is the case unless there are counts
+ * for all alleles of the event and they are not all 0. **/
+double GenotypingResults::GetVaf(const Event& event, int alt_allele) const {
+  if (support_.GetNumberOfAlleles() != 1 + event.GetNumberOfAltAlleles()) {
+    return -1;
   }
+  return support_.GetVaf(alt_allele);
 }
 
-/** Destructor **/
-GenotypingResults::~GenotypingResults() {
+/** Does the genotype have an alt allele? Only then is the call about one
+ * alt allele in particular; a homref or unknown call is about any. **/
+bool GenotypingResults::HasAltAllele() const {
+  return !genotype_.IsUnknown() && !genotype_.IsHomRef();
 }
 
 /** returns the genotype (aborts when genotype pointer is NULL) **/
@@ -15,21 +15,33 @@
 
 
 
+#include "DelimiterIndex.h"
+#include "Event.h"
+#include "FormatPlan.h"
 #include "Genotype.h"
+#include "Span.h"
 #include "Support.h"
 
 class GenotypingResults {
   friend std::ostream& operator<<(std::ostream& os,
-      GenotypingResults genotyping_results);
+      const GenotypingResults& genotyping_results);
 
 public:
-  GenotypingResults(const std::string& genotyping_data_as_string, bool is_pindel);
+  GenotypingResults(const Span& genotyping_data,
+      const DelimiterIndex& delimiters, const FormatPlan& format_plan,
+      bool is_pindel);
+  GenotypingResults(const Genotype& genotype, const Support& support);
   virtual ~GenotypingResults();
 
+  void AppendTo(std::string* text) const;
+  int GetAltAllele(const Event& event) const;
   Genotype& GetGenotype();
   Support& GetSupport();
   const Genotype& GetGenotype() const;
   const Support& GetSupport() const;
+  double GetVaf(const Event& event) const;
+  double GetVaf(const Event& event, int alt_allele) const;
+  bool HasAltAllele() const;
 
 private:
   Genotype genotype_;
@@ -0,0 +1,297 @@
+/*
+ * Instrumentation.cpp
+ *
+ * Measures where the time of a run goes: per thread, the wall time spent in
+ * each stage of the analysis (I/O, parsing, confidence estimation,
+ * classification and output), the CPU time and the records and bytes
+ * processed; for the whole process, the CPU time and the peak memory use.
+ * The measurements are written as a JSON report at the end of the run and,
+ * if asked for, every few seconds during the run.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "Instrumentation.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include "Utilities.h"
+
+namespace {
+
+const char* const STAGE_NAMES[NUMBER_OF_INSTRUMENTED_STAGES] = { "io",
+    "parsing", "confidence", "classification", "output" };
+
+/** Returns the text as a JSON string. **/
+std::string Quote(const std::string& text) {
+  std::string quoted = "\"";
+  for (size_t index = 0; index < text.size(); ++index) {
+    unsigned char ch = text[index];
+    if (ch == '"' || ch == '\\') {
+      quoted.push_back('\\');
+      quoted.push_back(ch);
+    }
+    else if (ch < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+      quoted.append(escaped);
+    }
+    else {
+      quoted.push_back(ch);
+    }
+  }
+  quoted.push_back('"');
+  return quoted;
+}
+
+/** Converts a time in nanoseconds to seconds. **/
+double ToSeconds(long long nanoseconds) {
+  return nanoseconds / 1e9;
+}
+
+/** Converts a time of getrusage to seconds. **/
+double ToSeconds(const timeval& time) {
+  return time.tv_sec + time.tv_usec / 1e6;
+}
+
+/** Writes the stage times as a JSON object. **/
+void WriteStages(const long long* stage_nanoseconds, std::ostream& report) {
+  report << "{";
+  for (int stage = 0; stage < NUMBER_OF_INSTRUMENTED_STAGES; ++stage) {
+    report << (stage == 0 ? "" : ", ") << Quote(STAGE_NAMES[stage]) <<
+        ": " << ToSeconds(stage_nanoseconds[stage]);
+  }
+  report << "}";
+}
+
+} // namespace
+
+/** Constructor; all counts start at zero. **/
+ThreadCounters::ThreadCounters(const std::string& name) : name(name),
+    cpu_nanoseconds(0), records(0), bytes(0), bytes_written(0) {
+  for (int stage = 0; stage < NUMBER_OF_INSTRUMENTED_STAGES; ++stage) {
+    stage_nanoseconds[stage] = 0;
+  }
+}
+
+/** Adds to a counter. Only the thread that owns the counter writes to it,
+ * so it does not need an atomic (and slower) read-modify-write. **/
+void ThreadCounters::Add(std::atomic<long long>* counter, long long amount) {
+  counter->store(counter->load(std::memory_order_relaxed) + amount,
+      std::memory_order_relaxed);
+}
+
+/** Stores the CPU time used so far by the calling thread, which should be
+ * the thread that the counters belong to. **/
+void ThreadCounters::UpdateCpuTime() {
+  timespec cpu_time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) == 0) {
+    cpu_nanoseconds.store(cpu_time.tv_sec * 1000000000LL + cpu_time.tv_nsec,
+        std::memory_order_relaxed);
+  }
+}
+
+/** Constructor; the thread is idle until the first switch. **/
+StageTimer::StageTimer(ThreadCounters* counters) : counters_(counters),
+    stage_(-1) {
+}
+
+/** Destructor; books the time of the current stage. **/
+StageTimer::~StageTimer() {
+  Stop();
+  UpdateCpuTime();
+}
+
+/** Counts bytes of input processed. **/
+void StageTimer::AddBytes(size_t number_of_bytes) {
+  if (counters_ != NULL) {
+    ThreadCounters::Add(&counters_->bytes, number_of_bytes);
+  }
+}
+
+/** Counts bytes of output written. **/
+void StageTimer::AddBytesWritten(size_t number_of_bytes) {
+  if (counters_ != NULL) {
+    ThreadCounters::Add(&counters_->bytes_written, number_of_bytes);
+  }
+}
+
+/** Counts a record processed. **/
+void StageTimer::AddRecord() {
+  if (counters_ != NULL) {
+    ThreadCounters::Add(&counters_->records, 1);
+  }
+}
+
+/** Books the time since the last switch; the thread is idle until the next
+ * switch. **/
+void StageTimer::Stop() {
+  if (counters_ != NULL) {
+    SwitchTo(-1);
+  }
+}
+
+/** Stores the CPU time of the thread. Costs a system call, so should not be
+ * called for every record. **/
+void StageTimer::UpdateCpuTime() {
+  if (counters_ != NULL) {
+    counters_->UpdateCpuTime();
+  }
+}
+
+/** Books the time since the last switch to the current stage (if any), and
+ * goes to 'stage'. **/
+void StageTimer::SwitchTo(int stage) {
+  std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (stage_ >= 0) {
+    ThreadCounters::Add(&counters_->stage_nanoseconds[stage_],
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now - start_of_stage_).count());
+  }
+  stage_ = stage;
+  start_of_stage_ = now;
+}
+
+/** Constructor; without the name of a report file, nothing is measured. With
+ * 'seconds_between_reports' > 0, the report is also written during the run.
+ * **/
+Instrumentation::Instrumentation(const std::string& name_of_input_file,
+    const std::string& name_of_report_file, int seconds_between_reports) :
+    name_of_input_file_(name_of_input_file),
+    name_of_report_file_(name_of_report_file),
+    seconds_between_reports_(seconds_between_reports),
+    start_(std::chrono::steady_clock::now()), is_finished_(false) {
+}
+
+/** Destructor **/
+Instrumentation::~Instrumentation() {
+  if (report_thread_.joinable()) {
+    Finish();
+  }
+  for (size_t index = 0; index < threads_.size(); ++index) {
+    delete threads_[index];
+  }
+}
+
+/** Makes the counters for a thread; returns NULL if nothing is measured.
+ * The counters stay valid as long as the instrumentation exists. **/
+ThreadCounters* Instrumentation::AddThread(const std::string& name) {
+  if (!IsEnabled()) {
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  threads_.push_back(new ThreadCounters(name));
+  return threads_.back();
+}
+
+/** Stops the periodic reports, and writes the final report. **/
+void Instrumentation::Finish() {
+  if (!IsEnabled()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_finished_ = true;
+    finished_.notify_all();
+  }
+  if (report_thread_.joinable()) {
+    report_thread_.join();
+  }
+  WriteReport(true);
+}
+
+/** Is anything measured? **/
+bool Instrumentation::IsEnabled() const {
+  return !name_of_report_file_.empty();
+}
+
+/** Starts the periodic reports, if asked for. **/
+void Instrumentation::Start() {
+  if (IsEnabled() && seconds_between_reports_ > 0) {
+    report_thread_ = std::thread(&Instrumentation::WritePeriodicReports,
+        this);
+  }
+}
+
+/** The report thread: writes a report every few seconds until the run is
+ * finished. **/
+void Instrumentation::WritePeriodicReports() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!is_finished_) {
+    finished_.wait_for(lock, std::chrono::seconds(seconds_between_reports_));
+    if (!is_finished_) {
+      lock.unlock();
+      WriteReport(false);
+      lock.lock();
+    }
+  }
+}
+
+/** Writes the report to a temporary file, which then replaces the report
+ * file, so that a reader never sees half a report. **/
+void Instrumentation::WriteReport(bool is_final) {
+  double elapsed_seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_).count();
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  std::stringstream threads;
+  long long total_stage_nanoseconds[NUMBER_OF_INSTRUMENTED_STAGES] = { 0 };
+  long long total_records = 0;
+  long long total_bytes = 0;
+  long long total_bytes_written = 0;
+  threads << std::fixed << std::setprecision(6);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t index = 0; index < threads_.size(); ++index) {
+      const ThreadCounters& counters = *threads_[index];
+      long long stage_nanoseconds[NUMBER_OF_INSTRUMENTED_STAGES];
+      for (int stage = 0; stage < NUMBER_OF_INSTRUMENTED_STAGES; ++stage) {
+        stage_nanoseconds[stage] = counters.stage_nanoseconds[stage];
+        total_stage_nanoseconds[stage] += stage_nanoseconds[stage];
+      }
+      total_records += counters.records;
+      total_bytes += counters.bytes;
+      total_bytes_written += counters.bytes_written;
+      threads << (index == 0 ? "" : ",") << "\n    {\"name\": " <<
+          Quote(counters.name) << ", \"cpu_seconds\": " <<
+          ToSeconds(counters.cpu_nanoseconds) << ", \"records\": " <<
+          counters.records << ", \"bytes\": " << counters.bytes <<
+          ", \"bytes_written\": " << counters.bytes_written <<
+          ",\n     \"stage_seconds\": ";
+      WriteStages(stage_nanoseconds, threads);
+      threads << "}";
+    }
+  }
+
+  std::stringstream report;
+  report << std::fixed << std::setprecision(6);
+  report << "{\n  \"input\": " << Quote(name_of_input_file_) << ",\n" <<
+      "  \"final\": " << (is_final ? "true" : "false") << ",\n" <<
+      "  \"elapsed_seconds\": " << elapsed_seconds << ",\n" <<
+      "  \"user_cpu_seconds\": " << ToSeconds(usage.ru_utime) << ",\n" <<
+      "  \"system_cpu_seconds\": " << ToSeconds(usage.ru_stime) << ",\n" <<
+      "  \"peak_rss_kb\": " << usage.ru_maxrss << ",\n" <<
+      "  \"records\": " << total_records << ",\n" <<
+      "  \"bytes\": " << total_bytes << ",\n" <<
+      "  \"bytes_written\": " << total_bytes_written << ",\n" <<
+      "  \"stage_seconds\": ";
+  WriteStages(total_stage_nanoseconds, report);
+  report << ",\n  \"threads\": [" << threads.str() << "\n  ]\n}\n";
+
+  std::string name_of_temporary_file = name_of_report_file_ + ".tmp";
+  std::ofstream report_file(name_of_temporary_file.c_str());
+  report_file << report.str();
+  report_file.close();
+  Utilities::Require(report_file.good() &&
+      rename(name_of_temporary_file.c_str(), name_of_report_file_.c_str()) ==
+      0, "Instrumentation error: cannot write report file " +
+      name_of_report_file_);
+}
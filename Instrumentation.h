@@ -0,0 +1,101 @@
+/*
+ * Instrumentation.h
+ *
+ * Measures where the time of a run goes: per thread, the wall time spent in
+ * each stage of the analysis (I/O, parsing, confidence estimation,
+ * classification and output), the CPU time and the records and bytes
+ * processed; for the whole process, the CPU time and the peak memory use.
+ * The measurements are written as a JSON report at the end of the run and,
+ * if asked for, every few seconds during the run.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INSTRUMENTATION_H_
+#define INSTRUMENTATION_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum InstrumentedStage { kIoStage, kParsingStage, kConfidenceStage,
+  kClassificationStage, kOutputStage };
+const int NUMBER_OF_INSTRUMENTED_STAGES = kOutputStage + 1;
+
+// the measurements of one thread; only that thread changes them, but the
+// report thread may read them at any time
+struct ThreadCounters {
+  explicit ThreadCounters(const std::string& name);
+
+  static void Add(std::atomic<long long>* counter, long long amount);
+  void UpdateCpuTime();
+
+  std::string name;
+  std::atomic<long long> stage_nanoseconds[NUMBER_OF_INSTRUMENTED_STAGES];
+  std::atomic<long long> cpu_nanoseconds;
+  std::atomic<long long> records;
+  // the bytes of input read and of output written
+  std::atomic<long long> bytes;
+  std::atomic<long long> bytes_written;
+};
+
+// books the wall time of a thread to the stage it is in; does nothing if it
+// has no counters, so it costs next to nothing when nobody asked for a report
+class StageTimer {
+public:
+  explicit StageTimer(ThreadCounters* counters);
+  ~StageTimer();
+
+  /** Books the time since the last switch, and goes to 'stage'. **/
+  void Switch(InstrumentedStage stage) {
+    if (counters_ != NULL) {
+      SwitchTo(stage);
+    }
+  }
+
+  void AddBytes(size_t number_of_bytes);
+  void AddBytesWritten(size_t number_of_bytes);
+  void AddRecord();
+  void Stop();
+  void UpdateCpuTime();
+
+private:
+  void SwitchTo(int stage);
+
+  ThreadCounters* counters_;
+  // the current stage, or -1 if the thread is idle
+  int stage_;
+  std::chrono::steady_clock::time_point start_of_stage_;
+};
+
+class Instrumentation {
+public:
+  Instrumentation(const std::string& name_of_input_file,
+      const std::string& name_of_report_file, int seconds_between_reports);
+  virtual ~Instrumentation();
+
+  ThreadCounters* AddThread(const std::string& name);
+  void Finish();
+  bool IsEnabled() const;
+  void Start();
+
+private:
+  void WritePeriodicReports();
+  void WriteReport(bool is_final);
+
+  std::string name_of_input_file_;
+  std::string name_of_report_file_;
+  int seconds_between_reports_;
+  std::chrono::steady_clock::time_point start_;
+  std::vector<ThreadCounters*> threads_;
+  bool is_finished_;
+  std::mutex mutex_;
+  std::condition_variable finished_;
+  std::thread report_thread_;
+};
+
+#endif /* INSTRUMENTATION_H_ */
@@ -0,0 +1,223 @@
+/*
+ * MendelianErrorMap.cpp
+ *
+ * Counts how often each combination of parental and child genotypes occurs
+ * among the Mendelian errors. Trios of which all genotypes have a code (see
+ * Genotype::GetCode) are counted in a dense array indexed by the codes; the
+ * others in a hash map keyed by the alleles. The human-readable descriptions
+ * ("0/0,0/1 => 1/1") are only made when the counts are shown.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "MendelianErrorMap.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Utilities.h"
+
+/** Are two keys the same trio of genotypes? **/
+bool MendelianErrorMap::TrioKey::operator==(const TrioKey& other) const {
+  return memcmp(alleles, other.alleles, sizeof(alleles)) == 0 &&
+      memcmp(ploidies, other.ploidies, sizeof(ploidies)) == 0;
+}
+
+/** FNV-1a hash of the alleles and ploidies of a key. **/
+size_t MendelianErrorMap::TrioKeyHash::operator()(const TrioKey& key) const {
+  size_t hash = 14695981039346656037ULL;
+  const unsigned char* bytes =
+      reinterpret_cast<const unsigned char*>(key.alleles);
+  for (size_t index = 0; index < sizeof(key.alleles); ++index) {
+    hash = (hash ^ bytes[index]) * 1099511628211ULL;
+  }
+  for (size_t index = 0; index < sizeof(key.ploidies); ++index) {
+    hash = (hash ^ key.ploidies[index]) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/** Constructor; no errors counted yet. **/
+MendelianErrorMap::MendelianErrorMap() {
+  std::fill(coded_counts_, coded_counts_ + NUMBER_OF_CODED_TRIOS, 0);
+}
+
+/** Counts one Mendelian error. Phased and unphased genotypes with the same
+ * alleles are counted, and described, as the same genotype. **/
+void MendelianErrorMap::Add(const Genotype& firstParentGenotype,
+    const Genotype& secondParentGenotype, const Genotype& childGenotype) {
+  int first_code = firstParentGenotype.GetCode();
+  int second_code = secondParentGenotype.GetCode();
+  int child_code = childGenotype.GetCode();
+  if (first_code != Genotype::NO_CODE && second_code != Genotype::NO_CODE &&
+      child_code != Genotype::NO_CODE) {
+    first_code = Genotype::GetUnphasedCode(first_code);
+    second_code = Genotype::GetUnphasedCode(second_code);
+    child_code = Genotype::GetUnphasedCode(child_code);
+    if (first_code > second_code) {
+      std::swap(first_code, second_code);
+    }
+    ++coded_counts_[(first_code * Genotype::NUMBER_OF_UNPHASED_CODES +
+        second_code) * Genotype::NUMBER_OF_UNPHASED_CODES + child_code];
+  }
+  else {
+    ++other_counts_[MakeKey(firstParentGenotype, secondParentGenotype,
+        childGenotype)];
+  }
+}
+
+/** Adds the counts of another map to this one. **/
+void MendelianErrorMap::Merge(const MendelianErrorMap& other) {
+  for (int index = 0; index < NUMBER_OF_CODED_TRIOS; ++index) {
+    coded_counts_[index] += other.coded_counts_[index];
+  }
+  for (std::unordered_map<TrioKey, int, TrioKeyHash>::const_iterator it =
+      other.other_counts_.begin(); it != other.other_counts_.end(); ++it) {
+    other_counts_[it->first] += it->second;
+  }
+}
+
+/** Reads the counts as written by WriteTo, replacing the current ones. **/
+void MendelianErrorMap::ReadFrom(std::istream& is) {
+  std::fill(coded_counts_, coded_counts_ + NUMBER_OF_CODED_TRIOS, 0);
+  other_counts_.clear();
+  size_t number_of_coded_trios = 0;
+  is >> number_of_coded_trios;
+  for (size_t count_index = 0; count_index < number_of_coded_trios && is;
+      ++count_index) {
+    int index = 0;
+    int count = 0;
+    is >> index >> count;
+    if (index >= 0 && index < NUMBER_OF_CODED_TRIOS) {
+      coded_counts_[index] = count;
+    }
+    else {
+      is.setstate(std::ios::failbit);
+    }
+  }
+  size_t number_of_other_trios = 0;
+  is >> number_of_other_trios;
+  for (size_t count_index = 0; count_index < number_of_other_trios && is;
+      ++count_index) {
+    TrioKey key;
+    memset(&key, 0, sizeof(key));
+    for (int genotype_index = 0; genotype_index < 3; ++genotype_index) {
+      int ploidy = 0;
+      is >> ploidy;
+      if (ploidy < 0 || ploidy > Genotype::MAX_PLOIDY) {
+        is.setstate(std::ios::failbit);
+        return;
+      }
+      key.ploidies[genotype_index] = ploidy;
+      for (int allele_index = 0; allele_index < ploidy; ++allele_index) {
+        is >> key.alleles[genotype_index][allele_index];
+      }
+    }
+    is >> other_counts_[key];
+  }
+}
+
+/** Writes the counts, so they can be read back with ReadFrom: the number of
+ * coded trios with errors and their indices and counts, then the number of
+ * other trios and per trio the ploidy and alleles of each genotype and the
+ * count. **/
+void MendelianErrorMap::WriteTo(std::ostream& os) const {
+  int number_of_coded_trios = NUMBER_OF_CODED_TRIOS -
+      std::count(coded_counts_, coded_counts_ + NUMBER_OF_CODED_TRIOS, 0);
+  os << number_of_coded_trios;
+  for (int index = 0; index < NUMBER_OF_CODED_TRIOS; ++index) {
+    if (coded_counts_[index] != 0) {
+      os << " " << index << " " << coded_counts_[index];
+    }
+  }
+  os << "\n" << other_counts_.size();
+  for (std::unordered_map<TrioKey, int, TrioKeyHash>::const_iterator it =
+      other_counts_.begin(); it != other_counts_.end(); ++it) {
+    for (int genotype_index = 0; genotype_index < 3; ++genotype_index) {
+      int ploidy = it->first.ploidies[genotype_index];
+      os << " " << ploidy;
+      for (int allele_index = 0; allele_index < ploidy; ++allele_index) {
+        os << " " << it->first.alleles[genotype_index][allele_index];
+      }
+    }
+    os << " " << it->second;
+  }
+}
+
+/** Returns the number of errors per trio description, such as
+ * "0/0,0/1 => 1/1", in which the parents are sorted alphabetically. **/
+std::map<std::string, int> MendelianErrorMap::GetCountsPerDescription()
+    const {
+  std::map<std::string, int> counts_per_description;
+  for (int index = 0; index < NUMBER_OF_CODED_TRIOS; ++index) {
+    if (coded_counts_[index] == 0) {
+      continue;
+    }
+    int child_code = index % Genotype::NUMBER_OF_UNPHASED_CODES;
+    int second_code = index / Genotype::NUMBER_OF_UNPHASED_CODES %
+        Genotype::NUMBER_OF_UNPHASED_CODES;
+    int first_code = index / Genotype::NUMBER_OF_UNPHASED_CODES /
+        Genotype::NUMBER_OF_UNPHASED_CODES;
+    counts_per_description[GetDescription(
+        Genotype::FromCode(first_code).AsString(),
+        Genotype::FromCode(second_code).AsString(),
+        Genotype::FromCode(child_code).AsString())] += coded_counts_[index];
+  }
+  for (std::unordered_map<TrioKey, int, TrioKeyHash>::const_iterator it =
+      other_counts_.begin(); it != other_counts_.end(); ++it) {
+    counts_per_description[GetDescription(GetGenotypeAsString(it->first, 0),
+        GetGenotypeAsString(it->first, 1),
+        GetGenotypeAsString(it->first, 2))] += it->second;
+  }
+  return counts_per_description;
+}
+
+/** Makes the hash map key of a trio. **/
+MendelianErrorMap::TrioKey MendelianErrorMap::MakeKey(
+    const Genotype& firstParentGenotype, const Genotype& secondParentGenotype,
+    const Genotype& childGenotype) {
+  TrioKey key;
+  memset(&key, 0, sizeof(key));
+  const Genotype* genotypes[3] = { &firstParentGenotype,
+      &secondParentGenotype, &childGenotype };
+  for (int index = 0; index < 3; ++index) {
+    key.ploidies[index] = genotypes[index]->GetNumberOfAlleles();
+    for (int allele_index = 0; allele_index < key.ploidies[index];
+        ++allele_index) {
+      key.alleles[index][allele_index] =
+          genotypes[index]->GetAllele(allele_index);
+    }
+  }
+  return key;
+}
+
+/** Describes a trio as "parent,parent => child", with the parents sorted
+ * alphabetically. **/
+std::string MendelianErrorMap::GetDescription(
+    const std::string& firstParentGenotype,
+    const std::string& secondParentGenotype,
+    const std::string& childGenotype) {
+  std::string parents_string =
+      (firstParentGenotype <= secondParentGenotype) ?
+          (firstParentGenotype + "," + secondParentGenotype) :
+          (secondParentGenotype + "," + firstParentGenotype);
+  return parents_string + " => " + childGenotype;
+}
+
+/** Formats one of the genotypes of a key like Genotype::AsString does. **/
+std::string MendelianErrorMap::GetGenotypeAsString(const TrioKey& key,
+    int index) {
+  if (key.ploidies[index] == 0) {
+    return ".";
+  }
+  std::string genotype_as_string;
+  for (int allele_index = 0; allele_index < key.ploidies[index];
+      ++allele_index) {
+    if (allele_index > 0) {
+      genotype_as_string.push_back('/');
+    }
+    Utilities::AppendInteger(key.alleles[index][allele_index],
+        &genotype_as_string);
+  }
+  return genotype_as_string;
+}
@@ -0,0 +1,65 @@
+/*
+ * MendelianErrorMap.h
+ *
+ * Counts how often each combination of parental and child genotypes occurs
+ * among the Mendelian errors. Trios of which all genotypes have a code (see
+ * Genotype::GetCode) are counted in a dense array indexed by the codes; the
+ * others in a hash map keyed by the alleles. The human-readable descriptions
+ * ("0/0,0/1 => 1/1") are only made when the counts are shown.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef MENDELIANERRORMAP_H_
+#define MENDELIANERRORMAP_H_
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#include "Genotype.h"
+
+class MendelianErrorMap {
+public:
+  MendelianErrorMap();
+
+  void Add(const Genotype& firstParentGenotype,
+      const Genotype& secondParentGenotype, const Genotype& childGenotype);
+  std::map<std::string, int> GetCountsPerDescription() const;
+  void Merge(const MendelianErrorMap& other);
+  void ReadFrom(std::istream& is);
+  void WriteTo(std::ostream& os) const;
+
+private:
+  // phased genotypes are counted as their unphased forms
+  static const int NUMBER_OF_CODED_TRIOS =
+      Genotype::NUMBER_OF_UNPHASED_CODES *
+      Genotype::NUMBER_OF_UNPHASED_CODES * Genotype::NUMBER_OF_UNPHASED_CODES;
+
+  // the alleles of the three genotypes; unused positions are 0 and a ploidy
+  // of 0 means 'unknown'
+  struct TrioKey {
+    unsigned short alleles[3][Genotype::MAX_PLOIDY];
+    unsigned char ploidies[3];
+
+    bool operator==(const TrioKey& other) const;
+  };
+
+  struct TrioKeyHash {
+    size_t operator()(const TrioKey& key) const;
+  };
+
+  static TrioKey MakeKey(const Genotype& firstParentGenotype,
+      const Genotype& secondParentGenotype, const Genotype& childGenotype);
+  static std::string GetDescription(const std::string& firstParentGenotype,
+      const std::string& secondParentGenotype,
+      const std::string& childGenotype);
+  static std::string GetGenotypeAsString(const TrioKey& key, int index);
+
+  int coded_counts_[NUMBER_OF_CODED_TRIOS];
+  std::unordered_map<TrioKey, int, TrioKeyHash> other_counts_;
+};
+
+#endif /* MENDELIANERRORMAP_H_ */
@@ -0,0 +1,177 @@
+/*
+ * OutputWriter.cpp
+ *
+ * Writes the output file on a thread of its own. The analysis threads hand
+ * over their output in large batches, each to their own stream; the writer
+ * writes stream 0 completely, then stream 1, and so on, so the output is in
+ * the order of the input file no matter how the threads are scheduled. The
+ * stream being written holds only a few batches at a time: its thread waits
+ * if it gets too far ahead of the writer. The later streams are kept in
+ * memory until the writer gets to them, so that their threads never wait
+ * for the earlier ones. An interrupted analysis can continue an existing
+ * output file.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "OutputWriter.h"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Utilities.h"
+
+/** Constructor; creates (or empties) the output file. If the output file
+ * is continued, its contents are kept until ContinueAt says how much of it
+ * to keep. **/
+OutputWriter::OutputWriter(const std::string& name_of_output_file,
+    bool is_continued) : size_of_file_(0), counters_(NULL),
+    current_stream_(0) {
+  file_descriptor_ = open(name_of_output_file.c_str(),
+      O_WRONLY | O_CREAT | (is_continued ? 0 : O_TRUNC), 0644);
+  Utilities::Require(file_descriptor_ >= 0, "OutputWriter error: cannot "
+      "create output file " + name_of_output_file);
+}
+
+/** Destructor **/
+OutputWriter::~OutputWriter() {
+  if (writer_thread_.joinable()) {
+    Finish();
+  }
+  close(file_descriptor_);
+}
+
+/** Cuts the output file to 'size' bytes (the output written up to a
+ * checkpoint); the next batches are written behind those. Call before
+ * Start. **/
+void OutputWriter::ContinueAt(unsigned long long size) {
+  struct stat file_status;
+  Utilities::Require(fstat(file_descriptor_, &file_status) == 0 &&
+      static_cast<unsigned long long>(file_status.st_size) >= size &&
+      ftruncate(file_descriptor_, size) == 0 &&
+      lseek(file_descriptor_, size, SEEK_SET) >= 0,
+      "OutputWriter error: the output file is shorter than the checkpoint "
+      "says.");
+  size_of_file_ = size;
+}
+
+/** Starts the writer thread, which will write 'number_of_streams' streams
+ * one after the other. The time spent writing goes to 'counters' (if not
+ * NULL). **/
+void OutputWriter::Start(int number_of_streams, ThreadCounters* counters) {
+  streams_.assign(number_of_streams, Stream());
+  current_stream_ = 0;
+  counters_ = counters;
+  writer_thread_ = std::thread(&OutputWriter::WriteStreams, this);
+}
+
+/** Hands a batch of output lines to the writer. Takes over the contents of
+ * 'text', leaving it empty. Waits if the stream is being written and
+ * already holds the maximum number of batches. **/
+void OutputWriter::Submit(int stream_index, std::string* text) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  Stream& stream = streams_[stream_index];
+  while (static_cast<size_t>(stream_index) == current_stream_ &&
+      stream.batches.size() >= MAX_BATCHES_PER_STREAM) {
+    batch_written_.wait(lock);
+  }
+  Batch batch;
+  batch.sequence_number = stream.number_of_batches_submitted++;
+  stream.batches.push_back(batch);
+  stream.batches.back().text.swap(*text);
+  batch_submitted_.notify_one();
+}
+
+/** Hands a batch of output lines to the writer like Submit, then waits
+ * until all batches of the stream are in the output file and that is on
+ * disk. Returns the size of the output file. **/
+unsigned long long OutputWriter::Flush(int stream_index, std::string* text) {
+  Submit(stream_index, text);
+  unsigned long long size_of_file = 0;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Stream& stream = streams_[stream_index];
+    while (stream.number_of_batches_written <
+        stream.number_of_batches_submitted) {
+      batch_written_.wait(lock);
+    }
+    size_of_file = size_of_file_;
+  }
+  Utilities::Require(fdatasync(file_descriptor_) == 0,
+      "OutputWriter::Flush error: cannot write to output file.");
+  return size_of_file;
+}
+
+/** Tells the writer that no more batches will come for this stream. **/
+void OutputWriter::CloseStream(int stream_index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_[stream_index].is_closed = true;
+  batch_submitted_.notify_one();
+}
+
+/** Waits until all streams have been closed and written. **/
+void OutputWriter::Finish() {
+  writer_thread_.join();
+}
+
+/** The writer thread: writes the batches of each stream in order of their
+ * sequence numbers, and the streams in order of their indices. **/
+void OutputWriter::WriteStreams() {
+  StageTimer stage_timer(counters_);
+  for (size_t stream_index = 0; stream_index < streams_.size();
+      ++stream_index) {
+    long expected_sequence_number = 0;
+    while (true) {
+      Batch batch;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Stream& stream = streams_[stream_index];
+        while (stream.batches.empty() && !stream.is_closed) {
+          batch_submitted_.wait(lock);
+        }
+        if (stream.batches.empty()) {
+          // stream closed and completely written; from now on, the thread
+          // of the next stream may have to wait for the writer
+          ++current_stream_;
+          break;
+        }
+        batch.sequence_number = stream.batches.front().sequence_number;
+        batch.text.swap(stream.batches.front().text);
+        stream.batches.pop_front();
+        batch_written_.notify_all();
+      }
+      Utilities::Require(batch.sequence_number == expected_sequence_number,
+          "OutputWriter::WriteStreams error: batches out of order.");
+      ++expected_sequence_number;
+      stage_timer.Switch(kOutputStage);
+      WriteText(batch.text);
+      stage_timer.Stop();
+      stage_timer.AddBytesWritten(batch.text.size());
+      stage_timer.UpdateCpuTime();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++streams_[stream_index].number_of_batches_written;
+        size_of_file_ += batch.text.size();
+        batch_written_.notify_all();
+      }
+    }
+  }
+}
+
+/** Writes text to the output file, continuing after partial writes. **/
+void OutputWriter::WriteText(const std::string& text) {
+  size_t bytes_written = 0;
+  while (bytes_written < text.size()) {
+    ssize_t result = write(file_descriptor_, text.data() + bytes_written,
+        text.size() - bytes_written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    Utilities::Require(result > 0,
+        "OutputWriter::WriteText error: cannot write to output file.");
+    bytes_written += result;
+  }
+}
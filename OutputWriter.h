@@ -0,0 +1,79 @@
+/*
+ * OutputWriter.h
+ *
+ * Writes the output file on a thread of its own. The analysis threads hand
+ * over their output in large batches, each to their own stream; the writer
+ * writes stream 0 completely, then stream 1, and so on, so the output is in
+ * the order of the input file no matter how the threads are scheduled. The
+ * stream being written holds only a few batches at a time: its thread waits
+ * if it gets too far ahead of the writer. The later streams are kept in
+ * memory until the writer gets to them, so that their threads never wait
+ * for the earlier ones. An interrupted analysis can continue an existing
+ * output file.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef OUTPUTWRITER_H_
+#define OUTPUTWRITER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Instrumentation.h"
+
+class OutputWriter {
+public:
+  OutputWriter(const std::string& name_of_output_file, bool is_continued);
+  virtual ~OutputWriter();
+
+  void ContinueAt(unsigned long long size);
+  void Start(int number_of_streams, ThreadCounters* counters);
+  void Submit(int stream_index, std::string* text);
+  unsigned long long Flush(int stream_index, std::string* text);
+  void CloseStream(int stream_index);
+  void Finish();
+
+  // analysis threads should submit batches of about this size
+  static const size_t BATCH_SIZE = 1 << 20;
+
+private:
+  struct Batch {
+    long sequence_number;
+    std::string text;
+  };
+
+  struct Stream {
+    Stream() : number_of_batches_submitted(0), number_of_batches_written(0),
+        is_closed(false) {}
+    std::deque<Batch> batches;
+    long number_of_batches_submitted;
+    long number_of_batches_written;
+    bool is_closed;
+  };
+
+  void WriteStreams();
+  void WriteText(const std::string& text);
+
+  // the most batches the stream being written holds
+  static const size_t MAX_BATCHES_PER_STREAM = 4;
+
+  int file_descriptor_;
+  // the size of the output file (as far as written by the writer thread)
+  unsigned long long size_of_file_;
+  // where the writer thread books its time; NULL if it is not measured
+  ThreadCounters* counters_;
+  std::vector<Stream> streams_;
+  // the index of the stream being written
+  size_t current_stream_;
+  std::mutex mutex_;
+  std::condition_variable batch_submitted_;
+  std::condition_variable batch_written_;
+  std::thread writer_thread_;
+};
+
+#endif /* OUTPUTWRITER_H_ */
@@ -0,0 +1,138 @@
+/*
+ * Pedigree.cpp
+ *
+ * The family structure of the samples, read from a PED file. When the
+ * sample names of the VCF file are known (from its #CHROM line), the
+ * families are turned into a trio plan: for every child of which both
+ * parents are in the file, the columns of father, mother and child.
+ * Without a PED file, every three consecutive samples form a trio.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "Pedigree.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "Utilities.h"
+#include "VcfRecord.h"
+
+/** Is the sample column needed by any trio? **/
+bool TrioPlan::IsSampleNeeded(int sample_index) const {
+  return static_cast<size_t>(sample_index) < is_sample_needed.size() &&
+      is_sample_needed[sample_index];
+}
+
+/** Constructor; without a PED file, the pedigree is empty. **/
+Pedigree::Pedigree() : is_loaded_(false), is_resolved_(false) {
+}
+
+/** Get the trio plan; only valid once the sample names have been
+ * resolved. **/
+const TrioPlan& Pedigree::GetTrioPlan() const {
+  return trio_plan_;
+}
+
+/** Has a PED file been read? **/
+bool Pedigree::IsLoaded() const {
+  return is_loaded_;
+}
+
+/** Have the individuals been matched to the sample columns yet? **/
+bool Pedigree::IsResolved() const {
+  return is_resolved_;
+}
+
+/** Makes the plan of a VCF file without a PED file: samples 0, 1 and 2 are
+ * the first trio, 3, 4 and 5 the second, and so on. Aborts if the number of
+ * samples is not a multiple of three. **/
+void Pedigree::MakeConsecutiveTrioPlan(int number_of_samples,
+    TrioPlan* trio_plan) {
+  if (number_of_samples % 3 != 0) {
+    std::cout << "This does not seem to be trio data!\n";
+    exit( -1 );
+  }
+  trio_plan->trios.clear();
+  for (int sample_index = 0; sample_index < number_of_samples;
+      sample_index += 3) {
+    Trio trio = { sample_index, sample_index + 1, sample_index + 2 };
+    trio_plan->trios.push_back(trio);
+  }
+  trio_plan->is_sample_needed.assign(number_of_samples, true);
+}
+
+/** Reads the PED file: whitespace-separated family ID, individual ID,
+ * father ID, mother ID, sex and phenotype, of which only the IDs of the
+ * individual and the parents are used. **/
+void Pedigree::ReadPedFile(const std::string& name_of_ped_file) {
+  std::ifstream ped_file(name_of_ped_file.c_str());
+  Utilities::Require(ped_file.good(),
+      "Pedigree error: cannot open PED file '" + name_of_ped_file + "'.");
+  std::string line;
+  while (std::getline(ped_file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::stringstream fields(line);
+    std::string family_id;
+    Individual individual;
+    fields >> family_id >> individual.id >> individual.father >>
+        individual.mother;
+    Utilities::Require(!individual.mother.empty(),
+        "Pedigree error: invalid PED line '" + line + "'.");
+    individuals_.push_back(individual);
+  }
+  is_loaded_ = true;
+}
+
+/** Matches the individuals to the sample columns named in the #CHROM line
+ * of the VCF file, and makes the trio plan. Children of which a parent is
+ * not in the file are skipped, as are samples that are in no trio. **/
+void Pedigree::ResolveSampleNames(const Span& header_line) {
+  std::map<std::string, int> sample_indices;
+  int number_of_samples = 0;
+  Span columns = header_line;
+  for (int column_index = 0; !columns.empty(); ++column_index) {
+    Span column = columns.Until('\t');
+    columns = columns.After('\t');
+    if (column_index >= VcfRecord::NUMBER_OF_FIXED_COLUMNS) {
+      sample_indices[column.ToString()] = number_of_samples++;
+    }
+  }
+
+  trio_plan_.trios.clear();
+  trio_plan_.is_sample_needed.assign(number_of_samples, false);
+  int number_of_incomplete_trios = 0;
+  for (size_t index = 0; index < individuals_.size(); ++index) {
+    const Individual& individual = individuals_[index];
+    if (individual.father == "0" || individual.mother == "0") {
+      continue;
+    }
+    std::map<std::string, int>::const_iterator father =
+        sample_indices.find(individual.father);
+    std::map<std::string, int>::const_iterator mother =
+        sample_indices.find(individual.mother);
+    std::map<std::string, int>::const_iterator child =
+        sample_indices.find(individual.id);
+    if (father == sample_indices.end() || mother == sample_indices.end() ||
+        child == sample_indices.end()) {
+      ++number_of_incomplete_trios;
+      continue;
+    }
+    Trio trio = { father->second, mother->second, child->second };
+    trio_plan_.trios.push_back(trio);
+    trio_plan_.is_sample_needed[trio.father] = true;
+    trio_plan_.is_sample_needed[trio.mother] = true;
+    trio_plan_.is_sample_needed[trio.child] = true;
+  }
+  std::cout << "\nPedigree: " << trio_plan_.trios.size() << " trio(s) in " <<
+      "the VCF file, " << number_of_incomplete_trios << " skipped because " <<
+      "a member is not in the VCF file\n";
+  Utilities::Require(!trio_plan_.trios.empty(),
+      "Pedigree error: none of the trios of the PED file is in the VCF file.");
+  is_resolved_ = true;
+}
@@ -0,0 +1,62 @@
+/*
+ * Pedigree.h
+ *
+ * The family structure of the samples, read from a PED file. When the
+ * sample names of the VCF file are known (from its #CHROM line), the
+ * families are turned into a trio plan: for every child of which both
+ * parents are in the file, the columns of father, mother and child.
+ * Without a PED file, every three consecutive samples form a trio.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef PEDIGREE_H_
+#define PEDIGREE_H_
+
+#include <string>
+#include <vector>
+
+#include "Span.h"
+
+// the indices of the sample columns (0-based) of a father, mother and child
+struct Trio {
+  int father;
+  int mother;
+  int child;
+};
+
+// the trios of a VCF file, and which sample columns they need
+struct TrioPlan {
+  bool IsSampleNeeded(int sample_index) const;
+
+  std::vector<Trio> trios;
+  std::vector<bool> is_sample_needed;
+};
+
+class Pedigree {
+public:
+  Pedigree();
+
+  const TrioPlan& GetTrioPlan() const;
+  bool IsLoaded() const;
+  bool IsResolved() const;
+  static void MakeConsecutiveTrioPlan(int number_of_samples,
+      TrioPlan* trio_plan);
+  void ReadPedFile(const std::string& name_of_ped_file);
+  void ResolveSampleNames(const Span& header_line);
+
+private:
+  // a line of the PED file: an individual and its parents ("0" if unknown)
+  struct Individual {
+    std::string id;
+    std::string father;
+    std::string mother;
+  };
+
+  std::vector<Individual> individuals_;
+  bool is_loaded_;
+  bool is_resolved_;
+  TrioPlan trio_plan_;
+};
+
+#endif /* PEDIGREE_H_ */
@@ -44,6 +44,22 @@ double Quality::GetCorrectnessFraction() const {
   }
 }
 
+/** Adds the calls counted by another Quality object to this one. **/
+void Quality::Merge(const Quality& other) {
+  correct_calls_ += other.correct_calls_;
+  incorrect_calls_ += other.incorrect_calls_;
+}
+
+/** Reads the counts as written by WriteTo. **/
+void Quality::ReadFrom(std::istream& is) {
+  is >> correct_calls_ >> incorrect_calls_;
+}
+
+/** Writes the counts, so they can be read back with ReadFrom. **/
+void Quality::WriteTo(std::ostream& os) const {
+  os << correct_calls_ << " " << incorrect_calls_;
+}
+
 /** returns the total number of calls. **/
 int Quality::GetTotalCalls() const {
   return correct_calls_ + incorrect_calls_;
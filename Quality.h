@@ -24,6 +24,9 @@ public:
 
   void AddOccurrence(bool success);
   double GetCorrectnessFraction() const;
+  void Merge(const Quality& other);
+  void ReadFrom(std::istream& is);
+  void WriteTo(std::ostream& os) const;
 
 
 private:
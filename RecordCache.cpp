@@ -0,0 +1,172 @@
+/*
+ * RecordCache.cpp
+ *
+ * Keeps the parsed records of an analysis in a compact binary form, so that
+ * they can be analyzed again (with other confidences, for example) without
+ * reading and parsing the VCF file again. Per record, the fixed columns are
+ * kept as text, for the output file; per sample that is in a trio, only the
+ * genotype (usually a single byte) and the support counts. The records are
+ * kept in an unlinked temporary file, so a large input file does not have to
+ * fit in memory.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "RecordCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Utilities.h"
+
+namespace {
+
+// the byte that precedes a genotype without a code, which is kept as is
+const unsigned char UNCODED_GENOTYPE = 0xFF;
+
+} // namespace
+
+/** Constructor; opens the temporary file, which is removed as soon as it is
+ * closed. **/
+RecordCache::RecordCache() : read_position_(0), samples_position_(NULL) {
+  file_ = tmpfile();
+  Utilities::Require(file_ != NULL,
+      "RecordCache error: cannot create a temporary file.");
+}
+
+/** Destructor **/
+RecordCache::~RecordCache() {
+  fclose(file_);
+}
+
+/** Adds a record at the end of the cache. **/
+void RecordCache::Add(const CachedRecord& record) {
+  size_t start_of_record = buffer_.size();
+  // the size of the record, filled in when it is known
+  buffer_.append(sizeof(unsigned int), '\0');
+  Utilities::AppendCompactNumber(record.fixed_columns.size(), &buffer_);
+  buffer_.append(record.fixed_columns.begin(), record.fixed_columns.size());
+  Utilities::AppendCompactNumber(
+      record.reference.begin() - record.fixed_columns.begin(), &buffer_);
+  Utilities::AppendCompactNumber(record.reference.size(), &buffer_);
+  Utilities::AppendCompactNumber(
+      record.alt.begin() - record.fixed_columns.begin(), &buffer_);
+  Utilities::AppendCompactNumber(record.alt.size(), &buffer_);
+  Utilities::AppendCompactNumber(record.number_of_samples, &buffer_);
+  Utilities::AppendCompactNumber(record.results.size(), &buffer_);
+  for (size_t index = 0; index < record.results.size(); ++index) {
+    const Genotype& genotype = record.results[index].GetGenotype();
+    int code = genotype.GetCode();
+    if (code != Genotype::NO_CODE) {
+      buffer_.push_back(static_cast<char>(code));
+    }
+    else {
+      buffer_.push_back(static_cast<char>(UNCODED_GENOTYPE));
+      buffer_.append(reinterpret_cast<const char*>(&genotype),
+          sizeof(genotype));
+    }
+    const Support& support = record.results[index].GetSupport();
+    Utilities::AppendCompactNumber(support.GetNumberOfAlleles(), &buffer_);
+    for (int allele = 0; allele < support.GetNumberOfAlleles(); ++allele) {
+      Utilities::AppendCompactCount(support.GetCount(allele), &buffer_);
+    }
+  }
+  unsigned int size_of_record = buffer_.size() - start_of_record -
+      sizeof(unsigned int);
+  memcpy(&buffer_[start_of_record], &size_of_record, sizeof(size_of_record));
+  if (buffer_.size() >= BLOCK_SIZE) {
+    Flush();
+  }
+}
+
+/** Writes the records added so far to the temporary file. **/
+void RecordCache::Flush() {
+  Utilities::Require(buffer_.empty() ||
+      fwrite(buffer_.data(), 1, buffer_.size(), file_) == buffer_.size(),
+      "RecordCache error: cannot write to the temporary file.");
+  buffer_.clear();
+}
+
+/** Makes sure that at least 'number_of_bytes' bytes from the read position
+ * on have been read; returns false if the cache does not have that many. **/
+bool RecordCache::Fill(size_t number_of_bytes) {
+  size_t available = read_buffer_.size() - read_position_;
+  if (available >= number_of_bytes) {
+    return true;
+  }
+  read_buffer_.erase(read_buffer_.begin(),
+      read_buffer_.begin() + read_position_);
+  read_position_ = 0;
+  size_t size_to_read = std::max(BLOCK_SIZE, number_of_bytes - available);
+  read_buffer_.resize(available + size_to_read);
+  size_t bytes_read = fread(&read_buffer_[available], 1, size_to_read, file_);
+  read_buffer_.resize(available + bytes_read);
+  return read_buffer_.size() >= number_of_bytes;
+}
+
+/** Reads the fixed columns of the next record; returns false if all records
+ * have been read. The samples are only read by ReadSamples. **/
+bool RecordCache::Next(CachedRecord* record) {
+  unsigned int size_of_record = 0;
+  if (!Fill(sizeof(size_of_record))) {
+    return false;
+  }
+  memcpy(&size_of_record, &read_buffer_[read_position_],
+      sizeof(size_of_record));
+  read_position_ += sizeof(size_of_record);
+  Utilities::Require(Fill(size_of_record),
+      "RecordCache error: the temporary file is damaged.");
+  const char* position = &read_buffer_[read_position_];
+  read_position_ += size_of_record;
+
+  size_t size_of_fixed_columns = Utilities::ReadCompactNumber(&position);
+  record->fixed_columns = Span(position, size_of_fixed_columns);
+  position += size_of_fixed_columns;
+  size_t offset = Utilities::ReadCompactNumber(&position);
+  record->reference = Span(record->fixed_columns.begin() + offset,
+      Utilities::ReadCompactNumber(&position));
+  offset = Utilities::ReadCompactNumber(&position);
+  record->alt = Span(record->fixed_columns.begin() + offset,
+      Utilities::ReadCompactNumber(&position));
+  record->number_of_samples = Utilities::ReadCompactNumber(&position);
+  record->results.clear();
+  samples_position_ = position;
+  return true;
+}
+
+/** Reads the samples of the record that Next read last into 'record'. **/
+void RecordCache::ReadSamples(CachedRecord* record) const {
+  const char* position = samples_position_;
+  size_t number_of_results = Utilities::ReadCompactNumber(&position);
+  record->results.clear();
+  for (size_t index = 0; index < number_of_results; ++index) {
+    Genotype genotype;
+    unsigned char code = static_cast<unsigned char>(*position++);
+    if (code != UNCODED_GENOTYPE) {
+      genotype = Genotype::FromCode(code);
+    }
+    else {
+      memcpy(&genotype, position, sizeof(genotype));
+      position += sizeof(genotype);
+    }
+    int counts[Support::MAX_ALLELES];
+    int number_of_counts = Utilities::ReadCompactNumber(&position);
+    for (int allele = 0; allele < number_of_counts; ++allele) {
+      counts[allele] = Utilities::ReadCompactCount(&position);
+    }
+    record->results.emplace_back(genotype,
+        Support(counts, number_of_counts));
+  }
+}
+
+/** Goes back to the first record, to read the records (again). Call after
+ * the last record has been added. **/
+void RecordCache::Rewind() {
+  Flush();
+  Utilities::Require(fflush(file_) == 0,
+      "RecordCache error: cannot write to the temporary file.");
+  rewind(file_);
+  read_buffer_.clear();
+  read_position_ = 0;
+  samples_position_ = NULL;
+}
@@ -0,0 +1,64 @@
+/*
+ * RecordCache.h
+ *
+ * Keeps the parsed records of an analysis in a compact binary form, so that
+ * they can be analyzed again (with other confidences, for example) without
+ * reading and parsing the VCF file again. Per record, the fixed columns are
+ * kept as text, for the output file; per sample that is in a trio, only the
+ * genotype (usually a single byte) and the support counts. The records are
+ * kept in an unlinked temporary file, so a large input file does not have to
+ * fit in memory.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef RECORDCACHE_H_
+#define RECORDCACHE_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "GenotypingResults.h"
+#include "Span.h"
+
+// a record as kept by the cache; the spans stay valid until the next record
+// is read. The results are only filled in by ReadSamples.
+struct CachedRecord {
+  Span fixed_columns;
+  // REF and ALT, within 'fixed_columns'
+  Span reference;
+  Span alt;
+  int number_of_samples;
+  // either all samples, or only those that are in a trio; in the order of
+  // the sample columns
+  std::vector<GenotypingResults> results;
+};
+
+class RecordCache {
+public:
+  RecordCache();
+  virtual ~RecordCache();
+
+  void Add(const CachedRecord& record);
+  bool Next(CachedRecord* record);
+  void ReadSamples(CachedRecord* record) const;
+  void Rewind();
+
+private:
+  void Flush();
+  bool Fill(size_t number_of_bytes);
+
+  static const size_t BLOCK_SIZE = 1 << 22;
+
+  FILE* file_;
+  // records that are added go here until there is a block of them
+  std::string buffer_;
+  // the records that have been read, and the position of the next one
+  std::vector<char> read_buffer_;
+  size_t read_position_;
+  // where the samples of the record read last start
+  const char* samples_position_;
+};
+
+#endif /* RECORDCACHE_H_ */
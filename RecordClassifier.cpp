@@ -0,0 +1,325 @@
+/*
+ * RecordClassifier.cpp
+ *
+ * The steps of the analysis of a single record, after its fixed columns
+ * have been parsed: reading the samples that are in a trio, estimating the
+ * confidence in their calls, classifying the trios, and writing the record
+ * to the output file. The analyzer takes every record through them; the
+ * benchmark measures them.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "RecordClassifier.h"
+
+#include <algorithm>
+
+#include "BioUtils.h"
+#include "Support.h"
+
+/** Constructor; the phase order and 'pindel' are taken from 'settings'. **/
+RecordClassifier::RecordClassifier(const Settings* settings) :
+    settings_(settings) {
+}
+
+/** Parses the samples of a record that are in a trio of 'trio_plan'. **/
+void RecordClassifier::ReadSamples(const VcfRecord& record,
+    const FormatPlan& format_plan, const TrioPlan& trio_plan,
+    ParsedSamples* samples) const {
+  samples->results.clear();
+  samples->results_index.assign(record.GetNumberOfSamples(), -1);
+  for (int sample_index = 0; sample_index < record.GetNumberOfSamples();
+      ++sample_index) {
+    if (trio_plan.IsSampleNeeded(sample_index)) {
+      samples->results_index[sample_index] = samples->results.size();
+      samples->results.push_back(GenotypingResults(
+          record.GetSample(sample_index), record.GetDelimiters(),
+          format_plan, settings_->isPindel()));
+    }
+  }
+}
+
+/** Estimates the confidence in the call of each of the parsed samples. **/
+void RecordClassifier::EstimateConfidences(
+    const CallConfidenceEstimator& call_confidence_estimator,
+    const Event& event, ParsedSamples* samples) const {
+  samples->confidences.clear();
+  for (size_t index = 0; index < samples->results.size(); ++index) {
+    samples->confidences.push_back(call_confidence_estimator.GetConfidence(
+        event, samples->results[index]));
+  }
+}
+
+/** Updates the Mendelian error map. **/
+void RecordClassifier::UpdateMendelianErrorMap(
+    const Genotype& firstParentGenotype,
+    const Genotype& secondParentGenotype, const Genotype& childGenotype,
+    Statistics* statistics) const {
+  statistics->mendelian_errors.Add(firstParentGenotype, secondParentGenotype,
+      childGenotype);
+}
+
+/** Scores the genotypes of a trio as correct or incorrect **/
+void RecordClassifier::ScoreAsCorrect(const ParsedSamples& samples,
+    const Trio& trio, const Event& event,
+    bool is_correct,
+    Statistics* statistics) const {
+  // a trio that is correct or erroneous has an alt allele somewhere
+  int alt_allele = std::max(1, GetTrioAltAllele(samples, trio, event));
+  const int members[] = { trio.father, trio.mother, trio.child };
+  for (int member = 0; member < 3; member++) {
+    const GenotypingResults& results =
+        samples.results[samples.results_index[members[member]]];
+    const Support& support = results.GetSupport();
+
+    // first: score VAFs (of the alt allele the trio is about)
+    double vaf = results.GetVaf(event, alt_allele);
+    if (vaf >= 0.0) {
+      int vaf_bin_index = vaf * Statistics::NUM_VAF_BINS;
+      statistics->vaf_qualities[vaf_bin_index].AddOccurrence(is_correct);
+    }
+
+    // then: score coverage
+    int total_support = support.GetTotalSupport();
+    if (total_support > Statistics::MAX_SUPPORT) {
+      total_support = Statistics::MAX_SUPPORT;
+    }
+    int support_bin_index = total_support / Statistics::COVERAGE_RESOLUTION;
+    statistics->coverage_qualities[support_bin_index].AddOccurrence(is_correct);
+
+
+    // finally: score event
+    EventType eventtype = event.GetType(alt_allele);
+    statistics->eventtype_qualities[eventtype].AddOccurrence(is_correct);
+  }
+}
+
+/** Scores a vector of genotypes as incorrect **/
+
+
+/** classifies/counts the trio as having unknown, correct or incorrect Mendelian
+ * inheritance. 'calls' holds the codes of the calls of the parsed samples;
+ * most trios are classified from those alone. **/
+bool RecordClassifier::ClassifyTrio(const ParsedSamples& samples,
+     const std::vector<signed char>& calls, const Trio& trio,
+     const Event& event, bool* is_genotypable, Statistics* statistics) const {
+  int first_parent;
+  int second_parent;
+  bool is_phase_aware = GetParents(samples, trio, &first_parent,
+      &second_parent);
+  int child = samples.results_index[trio.child];
+  BioUtils::TrioClass trio_class;
+  if (!BioUtils::GetTrioClassFromCodes(calls[first_parent],
+      calls[second_parent], calls[child], is_phase_aware, &trio_class)) {
+    trio_class = BioUtils::GetTrioClass(
+        GetCall(samples, calls, first_parent),
+        GetCall(samples, calls, second_parent),
+        GetCall(samples, calls, child), is_phase_aware);
+  }
+  *is_genotypable = (trio_class != BioUtils::kTrioNotAssessable);
+  switch (trio_class) {
+  case BioUtils::kTrioAllHomRef:
+    statistics->all_homref++;
+    break;
+  case BioUtils::kTrioCorrect:
+    statistics->mendelian_correct++;
+    ScoreAsCorrect(samples, trio, event, true, statistics);
+    return true;
+  case BioUtils::kTrioError:
+    statistics->mendelian_error++;
+    ScoreAsCorrect(samples, trio, event, false, statistics);
+    UpdateMendelianErrorMap(GetCall(samples, calls, first_parent),
+        GetCall(samples, calls, second_parent),
+        GetCall(samples, calls, child), statistics);
+    return true;
+  case BioUtils::kTrioNotAssessable:
+    statistics->unknown_count++;
+    break;
+  }
+  return false;
+}
+
+/** Returns the genotype called for a parsed sample, from its code in
+ * 'calls', or from the sample itself if the genotype has no code. **/
+Genotype RecordClassifier::GetCall(const ParsedSamples& samples,
+    const std::vector<signed char>& calls, int index) const {
+  return (calls[index] != Genotype::NO_CODE) ?
+      Genotype::FromCode(calls[index]) :
+      samples.results[index].GetGenotype();
+}
+
+/** Finds the parents of a trio in 'samples.results', in the order in which
+ * the phase of the child is checked: the parent of its first allele first
+ * (see Settings::GetPhaseOrder). Returns whether the phase is checked. **/
+bool RecordClassifier::GetParents(const ParsedSamples& samples,
+    const Trio& trio, int* first_parent, int* second_parent) const {
+  *first_parent = samples.results_index[trio.father];
+  *second_parent = samples.results_index[trio.mother];
+  if (settings_->GetPhaseOrder() == MOTHER_FIRST) {
+    std::swap(*first_parent, *second_parent);
+  }
+  return settings_->GetPhaseOrder() != IGNORE_PHASE;
+}
+
+/** Returns the alt allele of the event (1 for the first) that a trio is
+ * about: that of the call of the child if it has an alt allele, else that
+ * of the first parent whose call has one (see
+ * GenotypingResults::GetAltAllele). Returns 0 if none of the calls has an
+ * alt allele; such a trio is about whichever alt allele is investigated. **/
+int RecordClassifier::GetTrioAltAllele(const ParsedSamples& samples,
+    const Trio& trio, const Event& event) const {
+  if (event.HasSingleAltAllele()) {
+    return 1;
+  }
+  const int members[] = { trio.child, trio.father, trio.mother };
+  for (int member = 0; member < 3; member++) {
+    const GenotypingResults& results =
+        samples.results[samples.results_index[members[member]]];
+    if (results.HasAltAllele()) {
+      return results.GetAltAllele(event);
+    }
+  }
+  return 0;
+}
+
+/** Should a trio be analyzed with 'settings': is the alt allele it is
+ * about (see GetTrioAltAllele) of the type and size that are investigated?
+ * Always so if the event has a single alt allele. **/
+bool RecordClassifier::ShouldAnalyzeTrio(const ParsedSamples& samples,
+    const Trio& trio, const Event& event, const Settings& settings) const {
+  if (event.HasSingleAltAllele()) {
+    return true;
+  }
+  int alt_allele = GetTrioAltAllele(samples, trio, event);
+  return alt_allele == 0 || settings.ShouldAnalyzeAltAllele(event,
+      alt_allele);
+}
+
+/** Calls the parsed samples, and classifies the trios of 'trio_plan', into
+ * 'statistics'. Calls with a confidence below the minimal confidence of
+ * 'settings' become unknown; the codes of the genotypes called (see
+ * Genotype::GetCode) go to 'calls', one byte per sample, in the order of
+ * 'samples.results'. Of a multi-allelic event, only the calls and trios
+ * about alt alleles that 'settings' investigates are counted; homref and
+ * unknown calls are about any (see ShouldAnalyzeTrio).
+ * Returns true if any of the counted samples has been called with
+ * sufficient confidence as containing an alt-allele; only then does the
+ * record count as an event. **/
+bool RecordClassifier::ClassifySamples(const ParsedSamples& samples,
+    const Event& event, const TrioPlan& trio_plan, const Settings& settings,
+    std::vector<signed char>* calls, Statistics* statistics) const {
+  calls->clear();
+  bool success = false;
+  double min_confidence = settings.GetMinConfidence();
+  for (size_t index = 0; index < samples.results.size(); ++index) {
+    const Genotype& genotype = samples.results[index].GetGenotype();
+    bool is_called = samples.confidences[index] >= min_confidence &&
+        !genotype.IsUnknown();
+    calls->push_back(is_called ? genotype.GetCode() : Genotype::UNKNOWN_CODE);
+    if (!settings.ShouldAnalyzeCall(event, samples.results[index])) {
+      // the call is about an alt allele that is not investigated
+      continue;
+    }
+    if (!is_called) {
+      statistics->unknown_calls++;
+    } else if (genotype.IsHomRef()) {
+      statistics->homref_calls++;
+    } else {
+      statistics->variant_calls++;
+      success = true;
+    }
+  }
+
+  int number_of_genotyped_trios = 0;
+  bool all_genotyped = true;
+  for (size_t trio_index = 0; trio_index < trio_plan.trios.size();
+      ++trio_index) {
+    const Trio& trio = trio_plan.trios[trio_index];
+    if (!ShouldAnalyzeTrio(samples, trio, event, settings)) {
+      all_genotyped = false;
+      continue;
+    }
+    bool this_genotyped = false;
+    ClassifyTrio(samples, *calls, trio, event, &this_genotyped, statistics);
+    all_genotyped = all_genotyped && this_genotyped;
+  }
+  ++statistics->trio_count[number_of_genotyped_trios];
+  if (all_genotyped) {
+    ++statistics->all_genotyped;
+  }
+  if (success) {
+    ++statistics->event_count;
+  }
+  return success;
+}
+
+/** Adds the samples and trios of a record to the sweep over the minimal
+ * confidences. The record counts as an event up to the confidence of its
+ * most confident variant call. Like ClassifySamples, only counts the calls
+ * and trios of a multi-allelic event about alt alleles that are
+ * investigated. **/
+void RecordClassifier::AddToSweep(const ParsedSamples& samples,
+    const Event& event, const TrioPlan& trio_plan,
+    ConfidenceSweep* confidence_sweep) const {
+  double highest_variant_confidence = -1.0;
+  for (size_t index = 0; index < samples.results.size(); ++index) {
+    if (!settings_->ShouldAnalyzeCall(event, samples.results[index])) {
+      continue;
+    }
+    const Genotype& genotype = samples.results[index].GetGenotype();
+    confidence_sweep->AddCall(genotype, samples.confidences[index]);
+    if (!genotype.IsUnknown() && !genotype.IsHomRef()) {
+      highest_variant_confidence = std::max(highest_variant_confidence,
+          samples.confidences[index]);
+    }
+  }
+  confidence_sweep->AddEvent(highest_variant_confidence);
+
+  for (size_t trio_index = 0; trio_index < trio_plan.trios.size();
+      ++trio_index) {
+    const Trio& trio = trio_plan.trios[trio_index];
+    if (!ShouldAnalyzeTrio(samples, trio, event, *settings_)) {
+      continue;
+    }
+    int first_parent;
+    int second_parent;
+    bool is_phase_aware = GetParents(samples, trio, &first_parent,
+        &second_parent);
+    int child = samples.results_index[trio.child];
+    const double confidences[3] = { samples.confidences[first_parent],
+        samples.confidences[second_parent], samples.confidences[child] };
+    confidence_sweep->AddTrio(samples.results[first_parent].GetGenotype(),
+        samples.results[second_parent].GetGenotype(),
+        samples.results[child].GetGenotype(), confidences, is_phase_aware);
+  }
+}
+
+/** Appends the calls and the support of the samples to an output line, as
+ * GT:AD; the samples that are not in a trio are written as '.'. **/
+void RecordClassifier::AppendSamples(const ParsedSamples& samples,
+    const std::vector<signed char>& calls, std::string* output_line) const {
+  for (size_t sample_index = 0; sample_index < samples.results_index.size();
+      ++sample_index) {
+    output_line->push_back('\t');
+    int index = samples.results_index[sample_index];
+    if (index < 0) {
+      output_line->push_back('.');
+    } else {
+      GetCall(samples, calls, index).AppendTo(output_line);
+      output_line->push_back(':');
+      samples.results[index].GetSupport().AppendTo(output_line);
+    }
+  }
+}
+
+/** Appends an analyzed record to the output: its first 8 columns
+ * unchanged, then the calls and the support of its samples as GT:AD. **/
+void RecordClassifier::AppendRecord(const Span& fixed_columns,
+    const ParsedSamples& samples, const std::vector<signed char>& calls,
+    std::string* output) const {
+  // the FORMAT column describes what is written per sample
+  output->append(fixed_columns.begin(), fixed_columns.size());
+  output->append("\tGT:AD");
+  AppendSamples(samples, calls, output);
+  output->push_back('\n');
+}
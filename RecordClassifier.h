@@ -0,0 +1,81 @@
+/*
+ * RecordClassifier.h
+ *
+ * The steps of the analysis of a single record, after its fixed columns
+ * have been parsed: reading the samples that are in a trio, estimating the
+ * confidence in their calls, classifying the trios, and writing the record
+ * to the output file. The analyzer takes every record through them; the
+ * benchmark measures them.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef RECORDCLASSIFIER_H_
+#define RECORDCLASSIFIER_H_
+
+#include <string>
+#include <vector>
+
+#include "CallConfidenceEstimator.h"
+#include "ConfidenceSweep.h"
+#include "Event.h"
+#include "FormatPlan.h"
+#include "Genotype.h"
+#include "GenotypingResults.h"
+#include "Pedigree.h"
+#include "Settings.h"
+#include "Span.h"
+#include "Statistics.h"
+#include "VcfRecord.h"
+
+// the samples of a record that are in a trio, parsed, and the confidence
+// in the call of each; shared by all configurations
+struct ParsedSamples {
+  std::vector<GenotypingResults> results;
+  std::vector<double> confidences;
+  // per sample column, the index in 'results' (-1 if it is not needed)
+  std::vector<int> results_index;
+};
+
+class RecordClassifier {
+public:
+  explicit RecordClassifier(const Settings* settings);
+
+  void ReadSamples(const VcfRecord& record, const FormatPlan& format_plan,
+      const TrioPlan& trio_plan, ParsedSamples* samples) const;
+  void EstimateConfidences(
+      const CallConfidenceEstimator& call_confidence_estimator,
+      const Event& event, ParsedSamples* samples) const;
+  bool ClassifySamples(const ParsedSamples& samples, const Event& event,
+      const TrioPlan& trio_plan, const Settings& settings,
+      std::vector<signed char>* calls, Statistics* statistics) const;
+  void AddToSweep(const ParsedSamples& samples, const Event& event,
+      const TrioPlan& trio_plan, ConfidenceSweep* confidence_sweep) const;
+  void AppendRecord(const Span& fixed_columns, const ParsedSamples& samples,
+      const std::vector<signed char>& calls, std::string* output) const;
+
+private:
+  void AppendSamples(const ParsedSamples& samples,
+      const std::vector<signed char>& calls, std::string* output_line) const;
+  bool ClassifyTrio(const ParsedSamples& samples,
+      const std::vector<signed char>& calls, const Trio& trio,
+      const Event& event, bool* is_genotypable, Statistics* statistics) const;
+  Genotype GetCall(const ParsedSamples& samples,
+      const std::vector<signed char>& calls, int index) const;
+  bool GetParents(const ParsedSamples& samples, const Trio& trio,
+      int* first_parent, int* second_parent) const;
+  int GetTrioAltAllele(const ParsedSamples& samples, const Trio& trio,
+      const Event& event) const;
+  void ScoreAsCorrect(const ParsedSamples& samples, const Trio& trio,
+      const Event& event, bool is_correct, Statistics* statistics) const;
+  bool ShouldAnalyzeTrio(const ParsedSamples& samples, const Trio& trio,
+      const Event& event, const Settings& settings) const;
+  void UpdateMendelianErrorMap(const Genotype& firstParentGenotype,
+      const Genotype& secondParentGenotype, const Genotype& childGenotype,
+      Statistics* statistics) const;
+
+  // the settings of the main analysis
+  const Settings* settings_;
+};
+
+#endif /* RECORDCLASSIFIER_H_ */
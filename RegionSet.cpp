@@ -0,0 +1,166 @@
+/*
+ * RegionSet.cpp
+ *
+ * The genomic regions to which the analysis is restricted, given as
+ * 'chr:start-end' arguments or read from a BED file. Tells which regions a
+ * record overlaps, so results can be reported per region.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "RegionSet.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "Utilities.h"
+
+namespace {
+
+/** Reads a position; thousands separators (as in 'chr1:1,000,000') are
+ * allowed. **/
+long long ParsePosition(const std::string& text) {
+  std::string digits;
+  for (size_t index = 0; index < text.size(); ++index) {
+    if (text[index] != ',') {
+      digits.push_back(text[index]);
+    }
+  }
+  Utilities::Require(Utilities::isPositiveInteger(digits),
+      "RegionSet error: '" + text + "' is not a valid position.");
+  return atoll(digits.c_str());
+}
+
+/** Describes the region as 'chr:start-end'. **/
+std::string GetDefaultName(const GenomicRegion& region) {
+  std::stringstream name;
+  name << region.chromosome << ":" << region.start << "-" << region.end;
+  return name.str();
+}
+
+} // namespace
+
+/** Constructor; the set starts empty. **/
+RegionSet::RegionSet() {
+}
+
+/** Adds a region given as 'chr', 'chr:start' or 'chr:start-end' (1-based,
+ * inclusive, like in samtools and tabix). **/
+void RegionSet::AddRegion(const std::string& description) {
+  GenomicRegion region;
+  region.start = 1;
+  region.end = LLONG_MAX;
+  size_t colon = description.rfind(':');
+  region.chromosome = description.substr(0, colon);
+  if (colon != std::string::npos) {
+    std::string positions = description.substr(colon + 1);
+    size_t dash = positions.find('-');
+    region.start = ParsePosition(positions.substr(0, dash));
+    if (dash != std::string::npos) {
+      region.end = ParsePosition(positions.substr(dash + 1));
+    }
+  }
+  Utilities::Require(!region.chromosome.empty() && region.start >= 1 &&
+      region.start <= region.end,
+      "RegionSet error: invalid region '" + description + "'.");
+  region.name = description;
+  regions_.push_back(region);
+  IndexRegions();
+}
+
+/** Adds the regions of a BED file. BED positions are 0-based and the ends
+ * are exclusive; the optional fourth column names the region. **/
+void RegionSet::AddBedFile(const std::string& name_of_bed_file) {
+  std::ifstream bed_file(name_of_bed_file.c_str());
+  Utilities::Require(bed_file.good(),
+      "RegionSet error: cannot open BED file '" + name_of_bed_file + "'.");
+  std::string line;
+  while (std::getline(bed_file, line)) {
+    if (line.empty() || line[0] == '#' ||
+        Utilities::StringStartsWith(line, "track") ||
+        Utilities::StringStartsWith(line, "browser")) {
+      continue;
+    }
+    std::stringstream columns(line);
+    std::string start, end;
+    GenomicRegion region;
+    columns >> region.chromosome >> start >> end >> region.name;
+    region.start = ParsePosition(start) + 1;
+    region.end = ParsePosition(end);
+    Utilities::Require(region.start <= region.end,
+        "RegionSet error: invalid BED line '" + line + "'.");
+    if (region.name.empty()) {
+      region.name = GetDefaultName(region);
+    }
+    regions_.push_back(region);
+  }
+  IndexRegions();
+}
+
+/** Get the region with the given index (in the order of adding). **/
+const GenomicRegion& RegionSet::GetRegion(int index) const {
+  return regions_[index];
+}
+
+/** Get the number of regions. **/
+int RegionSet::GetNumberOfRegions() const {
+  return regions_.size();
+}
+
+/** Puts the indices of the regions that overlap positions 'start' to 'end'
+ * of the chromosome into 'region_indices'. **/
+void RegionSet::GetOverlappingRegions(const Span& chromosome, long long start,
+    long long end, std::vector<int>* region_indices) const {
+  region_indices->clear();
+  std::map<std::string, ChromosomeRegions>::const_iterator found =
+      regions_per_chromosome_.find(chromosome.ToString());
+  if (found == regions_per_chromosome_.end()) {
+    return;
+  }
+  const ChromosomeRegions& chromosome_regions = found->second;
+  // the regions that start after 'end' cannot overlap; of the others, walk
+  // back until no earlier region reaches 'start'
+  size_t index = std::upper_bound(chromosome_regions.starts.begin(),
+      chromosome_regions.starts.end(), end) -
+      chromosome_regions.starts.begin();
+  while (index > 0 && chromosome_regions.max_ends[index - 1] >= start) {
+    --index;
+    int region_index = chromosome_regions.region_indices[index];
+    if (regions_[region_index].end >= start) {
+      region_indices->push_back(region_index);
+    }
+  }
+}
+
+/** Is the analysis restricted to regions at all? **/
+bool RegionSet::IsEmpty() const {
+  return regions_.empty();
+}
+
+/** Sorts the regions of each chromosome by start position, for
+ * GetOverlappingRegions. **/
+void RegionSet::IndexRegions() {
+  std::map<std::string, std::vector<std::pair<long long, int> > > sorted;
+  for (size_t index = 0; index < regions_.size(); ++index) {
+    sorted[regions_[index].chromosome].push_back(
+        std::make_pair(regions_[index].start, index));
+  }
+  regions_per_chromosome_.clear();
+  for (std::map<std::string, std::vector<std::pair<long long, int> > >::
+      iterator it = sorted.begin(); it != sorted.end(); ++it) {
+    std::sort(it->second.begin(), it->second.end());
+    ChromosomeRegions& chromosome_regions =
+        regions_per_chromosome_[it->first];
+    long long max_end = 0;
+    for (size_t index = 0; index < it->second.size(); ++index) {
+      int region_index = it->second[index].second;
+      max_end = std::max(max_end, regions_[region_index].end);
+      chromosome_regions.starts.push_back(regions_[region_index].start);
+      chromosome_regions.region_indices.push_back(region_index);
+      chromosome_regions.max_ends.push_back(max_end);
+    }
+  }
+}
@@ -0,0 +1,55 @@
+/*
+ * RegionSet.h
+ *
+ * The genomic regions to which the analysis is restricted, given as
+ * 'chr:start-end' arguments or read from a BED file. Tells which regions a
+ * record overlaps, so results can be reported per region.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef REGIONSET_H_
+#define REGIONSET_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Span.h"
+
+// a region on one chromosome; positions are 1-based and inclusive
+struct GenomicRegion {
+  std::string chromosome;
+  long long start;
+  long long end;
+  std::string name;
+};
+
+class RegionSet {
+public:
+  RegionSet();
+
+  void AddBedFile(const std::string& name_of_bed_file);
+  void AddRegion(const std::string& description);
+  const GenomicRegion& GetRegion(int index) const;
+  int GetNumberOfRegions() const;
+  void GetOverlappingRegions(const Span& chromosome, long long start,
+      long long end, std::vector<int>* region_indices) const;
+  bool IsEmpty() const;
+
+private:
+  // the regions on one chromosome, sorted by start position
+  struct ChromosomeRegions {
+    std::vector<long long> starts;
+    std::vector<int> region_indices;
+    // the largest end position of the regions up to and including this one
+    std::vector<long long> max_ends;
+  };
+
+  void IndexRegions();
+
+  std::vector<GenomicRegion> regions_;
+  std::map<std::string, ChromosomeRegions> regions_per_chromosome_;
+};
+
+#endif /* REGIONSET_H_ */
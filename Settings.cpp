@@ -13,18 +13,44 @@
 
 #include <algorithm>
 #include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 
 #include "Utilities.h"
 
+namespace {
+
+/** Reads the minimal confidence of a 'cX' argument (such as 'c0.9') into
+ * 'confidence'; returns false if the argument is not a 'c' followed by a
+ * number. **/
+bool ParseConfidenceArgument(const std::string& argument,
+    double* confidence) {
+  if (argument.size() < 2 || argument[0] != 'c') {
+    return false;
+  }
+  const char* number = argument.c_str() + 1;
+  char* end_of_number = NULL;
+  *confidence = strtod(number, &end_of_number);
+  return end_of_number != number && *end_of_number == '\0';
+}
+
+} // namespace
+
 /** Constructor; sets initial values for variables. **/
 Settings::Settings() {
   variant_type_ = UNDEFINED;
   is_pindel_ = false;
+  is_sweeping_ = false;
+  is_calibrating_ = false;
   min_size_ = 0;
   max_size_ = INT_MAX;
   min_confidence_ = 0;
+  number_of_threads_ = 1;
+  phase_order_ = IGNORE_PHASE;
+  seconds_between_reports_ = 0;
+  seconds_between_checkpoints_ = 60;
+  name_of_output_file_ = "output";
   string_to_variant_type_map_["all"] = ALL;
   string_to_variant_type_map_["snp"] = SNP;
   string_to_variant_type_map_["sv"] = SV;
@@ -44,17 +70,103 @@ void Settings::Complete() {
 /** Adds an argument to global settings; aborts if an error happens. **/
 void Settings::Add(const char* command_line_argument) {
   std::string argument = command_line_argument;
-  std::transform(argument.begin(), argument.end(), argument.begin(), ::tolower);
+  // only the name of an option is case-insensitive, its value may be a path
+  size_t end_of_name = std::min(argument.find('='), argument.size());
+  std::transform(argument.begin(), argument.begin() + end_of_name,
+      argument.begin(), ::tolower);
   if (argument == "pindel") {
     Utilities::Require(is_pindel_ == false,
         "GlobalSettings::add error: cannot set pindel twice!");
     is_pindel_ = true;
   }
+  else if (argument == "sweep") {
+    is_sweeping_ = true;
+  }
+  else if (argument == "calibrate") {
+    is_calibrating_ = true;
+  }
   else if (Utilities::MapContainsKey(string_to_variant_type_map_,argument)) {
     Utilities::Require(variant_type_ == UNDEFINED,
               "GlobalSettings::add error: conflicting SV requests!");
 
     variant_type_ = string_to_variant_type_map_[argument];
+  } else if (Utilities::StringStartsWith(argument,"output=")) {
+    name_of_output_file_ = argument.substr(7);
+    Utilities::Require(!name_of_output_file_.empty(),
+        "GlobalSettings::add error: the name of the output file is empty.");
+  } else if (Utilities::StringStartsWith(argument,"region=")) {
+    std::string region = argument.substr(7);
+    Utilities::Require(!region.empty(),
+        "GlobalSettings::add error: the region is empty.");
+    regions_.push_back(region);
+  } else if (Utilities::StringStartsWith(argument,"bed=")) {
+    Utilities::Require(name_of_bed_file_.empty(),
+        "GlobalSettings::add error: cannot set the BED file twice!");
+    name_of_bed_file_ = argument.substr(4);
+    Utilities::Require(!name_of_bed_file_.empty(),
+        "GlobalSettings::add error: the name of the BED file is empty.");
+  } else if (Utilities::StringStartsWith(argument,"ped=")) {
+    Utilities::Require(name_of_ped_file_.empty(),
+        "GlobalSettings::add error: cannot set the PED file twice!");
+    name_of_ped_file_ = argument.substr(4);
+    Utilities::Require(!name_of_ped_file_.empty(),
+        "GlobalSettings::add error: the name of the PED file is empty.");
+  } else if (Utilities::StringStartsWith(argument,"report=")) {
+    name_of_report_file_ = argument.substr(7);
+    Utilities::Require(!name_of_report_file_.empty(),
+        "GlobalSettings::add error: the name of the report file is empty.");
+  } else if (Utilities::StringStartsWith(argument,"report_interval=")) {
+    std::string numberCandidate = argument.substr(16);
+    Utilities::Require(Utilities::isPositiveInteger(numberCandidate) &&
+        atoi(numberCandidate.c_str()) > 0,
+        "GlobalSettings::add error: the report interval must be at least 1 "
+        "second.");
+    seconds_between_reports_ = atoi(numberCandidate.c_str());
+  } else if (Utilities::StringStartsWith(argument,"checkpoint=")) {
+    name_of_checkpoint_file_ = argument.substr(11);
+    Utilities::Require(!name_of_checkpoint_file_.empty(),
+        "GlobalSettings::add error: the name of the checkpoint file is "
+        "empty.");
+  } else if (Utilities::StringStartsWith(argument,"checkpoint_interval=")) {
+    std::string numberCandidate = argument.substr(20);
+    Utilities::Require(Utilities::isPositiveInteger(numberCandidate) &&
+        atoi(numberCandidate.c_str()) > 0,
+        "GlobalSettings::add error: the checkpoint interval must be at "
+        "least 1 second.");
+    seconds_between_checkpoints_ = atoi(numberCandidate.c_str());
+  } else if (Utilities::StringStartsWith(argument,"resume=")) {
+    name_of_resume_file_ = argument.substr(7);
+    Utilities::Require(!name_of_resume_file_.empty(),
+        "GlobalSettings::add error: the name of the checkpoint file to "
+        "resume from is empty.");
+  } else if (Utilities::StringStartsWith(argument,"cache=")) {
+    Utilities::Require(name_of_cache_file_.empty(),
+        "GlobalSettings::add error: cannot set the cache file twice!");
+    name_of_cache_file_ = argument.substr(6);
+    Utilities::Require(!name_of_cache_file_.empty(),
+        "GlobalSettings::add error: the name of the cache file is empty.");
+  } else if (Utilities::StringStartsWith(argument,"configurations=")) {
+    Utilities::Require(name_of_configurations_file_.empty(),
+        "GlobalSettings::add error: cannot set the configurations file "
+        "twice!");
+    name_of_configurations_file_ = argument.substr(15);
+    Utilities::Require(!name_of_configurations_file_.empty(),
+        "GlobalSettings::add error: the name of the configurations file is "
+        "empty.");
+  } else if (Utilities::StringStartsWith(argument,"phased=")) {
+    Utilities::Require(phase_order_ == IGNORE_PHASE,
+        "GlobalSettings::add error: cannot set the phase order twice!");
+    std::string parent = Utilities::StringToLowerCase(argument.substr(7));
+    Utilities::Require(parent == "father" || parent == "mother",
+        "GlobalSettings::add error: 'phased' should be 'phased=father' or "
+        "'phased=mother'.");
+    phase_order_ = (parent == "father") ? FATHER_FIRST : MOTHER_FIRST;
+  } else if (Utilities::StringStartsWith(argument,"threads=")) {
+    std::string numberCandidate = argument.substr(8);
+    Utilities::Require(Utilities::isPositiveInteger(numberCandidate) &&
+        atoi(numberCandidate.c_str()) > 0,
+        "GlobalSettings::add error: number of threads must be at least 1.");
+    number_of_threads_ = atoi(numberCandidate.c_str());
   } else if (Utilities::StringStartsWith(argument,"size")) {
     std::string comparator = argument.substr(4,2);
     //std::cout << "Comparator: " << comparator << "\n";
@@ -76,8 +188,9 @@ void Settings::Add(const char* command_line_argument) {
       min_size_ = targetSize + 1;
     }
   } else if (Utilities::StringStartsWith(argument,"c")) {
-    std::string numberCandidate = argument.substr(1);
-    min_confidence_ = atof(numberCandidate.c_str());
+    Utilities::Require(ParseConfidenceArgument(argument, &min_confidence_),
+        "GlobalSettings::add error: '" + argument + "' is not a 'cX' "
+        "confidence filter with a number X.");
     std::cout << "Min confidence = " << min_confidence_ << std::endl;
   } else {
     Utilities::Require(false,
@@ -85,6 +198,22 @@ void Settings::Add(const char* command_line_argument) {
   }
 }
 
+/** Adds an argument that selects the variants to count: a variant type,
+ * a size limit or a minimal confidence. These are the only arguments that
+ * can differ between the configurations of a single run. **/
+void Settings::AddFilter(const char* filter_argument) {
+  std::string argument = filter_argument;
+  std::transform(argument.begin(), argument.end(), argument.begin(),
+      ::tolower);
+  double confidence = 0.0;
+  bool is_filter = Utilities::MapContainsKey(string_to_variant_type_map_,
+      argument) || Utilities::StringStartsWith(argument, "size") ||
+      ParseConfidenceArgument(argument, &confidence);
+  Utilities::Require(is_filter, "GlobalSettings::add error: '" + argument +
+      "' is not a type, size or confidence filter.");
+  Add(filter_argument);
+}
+
 /** get the variant type **/
 VariantType Settings::GetVariantType() const {
   return variant_type_;
@@ -101,6 +230,81 @@ int Settings::GetMinEventSize() const {
 }
 
 
+/** Get the name of the BED file with the regions to analyze (empty if
+ * none). **/
+std::string Settings::GetNameOfBedFile() const {
+  return name_of_bed_file_;
+}
+
+/** Get the name of the binary cache of the parsed input file, which is
+ * written if it does not exist yet and analyzed instead of the input file
+ * (empty if none). **/
+std::string Settings::GetNameOfCacheFile() const {
+  return name_of_cache_file_;
+}
+
+/** Get the name of the file to which checkpoints are written (empty if
+ * none). **/
+std::string Settings::GetNameOfCheckpointFile() const {
+  return name_of_checkpoint_file_;
+}
+
+/** Get the name of the file with the extra configurations that are
+ * counted in the same run (empty if none). **/
+std::string Settings::GetNameOfConfigurationsFile() const {
+  return name_of_configurations_file_;
+}
+
+/** Get the name of the file to which the analyzed records are written. **/
+std::string Settings::GetNameOfOutputFile() const {
+  return name_of_output_file_;
+}
+
+/** Get the name of the PED file with the families of the samples (empty if
+ * none). **/
+std::string Settings::GetNameOfPedFile() const {
+  return name_of_ped_file_;
+}
+
+/** Get the name of the file to which the JSON report with timings and
+ * counts is written (empty if none). **/
+std::string Settings::GetNameOfReportFile() const {
+  return name_of_report_file_;
+}
+
+/** Get the name of the checkpoint file from which an interrupted analysis
+ * is continued (empty if the analysis starts at the beginning). **/
+std::string Settings::GetNameOfResumeFile() const {
+  return name_of_resume_file_;
+}
+
+/** Get the number of threads that analyze the input file. **/
+int Settings::GetNumberOfThreads() const {
+  return number_of_threads_;
+}
+
+/** Get which parent the first allele of a phased child comes from, or
+ * IGNORE_PHASE. **/
+PhaseOrder Settings::GetPhaseOrder() const {
+  return phase_order_;
+}
+
+/** Get the number of seconds between checkpoints. **/
+int Settings::GetSecondsBetweenCheckpoints() const {
+  return seconds_between_checkpoints_;
+}
+
+/** Get the number of seconds between reports during the run (0 if the
+ * report is only written at the end). **/
+int Settings::GetSecondsBetweenReports() const {
+  return seconds_between_reports_;
+}
+
+/** Get the regions ('chr:start-end') to which the analysis is restricted. **/
+const std::vector<std::string>& Settings::GetRegions() const {
+  return regions_;
+}
+
 /** Get the maximal size of an event. **/
 int Settings::GetMaxEventSize() const {
   return max_size_;
@@ -112,6 +316,18 @@ bool Settings::isPindel() const {
   return is_pindel_;
 }
 
+/** Should the counts be gathered for the whole range of minimal confidences,
+ * in addition to the one of 'cX'? **/
+bool Settings::IsSweeping() const {
+  return is_sweeping_;
+}
+
+/** Should the confidences be calibrated on the qualities of the input file
+ * itself (in a first pass) instead of read from the quality files? **/
+bool Settings::IsCalibrating() const {
+  return is_calibrating_;
+}
+
 
 Settings::~Settings() {
   // TODO Auto-generated destructor stub
@@ -153,16 +369,42 @@ bool Settings::isSizeCorrect(int size) const {
 }
 
 
-/** Should this variant be analyzed? **/
+/** Should this variant be analyzed: is any of its alt alleles of the type
+ * and size that are investigated? **/
 bool Settings::ShouldAnalyzeVariant(const Event& event) const {
+  for (int alt_allele = 1; alt_allele <= event.GetNumberOfStoredAltAlleles();
+      ++alt_allele) {
+    if (ShouldAnalyzeAltAllele(event, alt_allele)) {
+      return true;
+    }
+  }
+  return false;
+}
 
-  if (!event.HasSingleAltAllele()) {
-    // events with multiple alt alleles are hard to genotype;
-    // skip them from statistics
+/** Should a call on an event that ShouldAnalyzeVariant be analyzed: is
+ * the alt allele it is about (see GenotypingResults::GetAltAllele) of the
+ * type and size that are investigated? Always so if the event has a single
+ * alt allele, and for a homref or unknown call, which is about whichever
+ * alt allele is investigated. **/
+bool Settings::ShouldAnalyzeCall(const Event& event,
+    const GenotypingResults& results) const {
+  return event.HasSingleAltAllele() || !results.HasAltAllele() ||
+      ShouldAnalyzeAltAllele(event, results.GetAltAllele(event));
+}
+
+/** Is this alt allele of the event (1 for the first) of the type and size
+ * that are investigated? An unsized allele ('*') never is, nor is an allele
+ * of which the size is not kept. **/
+bool Settings::ShouldAnalyzeAltAllele(const Event& event,
+    int alt_allele) const {
+  if (alt_allele > event.GetNumberOfStoredAltAlleles()) {
     return false;
   }
   int ref_size = event.RefSize();
-  int alt_size = event.AltSize();
+  int alt_size = event.AltSize(alt_allele);
+  if (alt_size == Event::UNSIZED_ALLELE) {
+    return false;
+  }
 
   int size_to_check = std::max(ref_size, alt_size);
   if (size_to_check > 1) {
@@ -172,5 +414,3 @@ bool Settings::ShouldAnalyzeVariant(const Event& event) const {
 
   return (isTypeCorrect(ref_size,alt_size) && isSizeCorrect(size_to_check));
 }
-
-
@@ -14,24 +14,49 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Event.h"
+#include "GenotypingResults.h"
 
 enum VariantType {UNDEFINED, ALL, SNP, SV, DEL, INS, RPL};
 
+// which parent the first allele of a phased child comes from; IGNORE_PHASE
+// checks phased children like unphased ones
+enum PhaseOrder {IGNORE_PHASE, FATHER_FIRST, MOTHER_FIRST};
+
 class Settings {
 public:
   Settings();
   virtual ~Settings();
 
   void Add(const char* argument);
+  void AddFilter(const char* argument);
   void Complete();
   bool isPindel() const;
+  bool IsCalibrating() const;
+  bool IsSweeping() const;
   int GetMaxEventSize() const;
   double GetMinConfidence() const;
+  std::string GetNameOfBedFile() const;
+  std::string GetNameOfCacheFile() const;
+  std::string GetNameOfCheckpointFile() const;
+  std::string GetNameOfConfigurationsFile() const;
+  std::string GetNameOfOutputFile() const;
+  std::string GetNameOfPedFile() const;
+  std::string GetNameOfReportFile() const;
+  std::string GetNameOfResumeFile() const;
 
   int GetMinEventSize() const;
+  int GetNumberOfThreads() const;
+  PhaseOrder GetPhaseOrder() const;
+  const std::vector<std::string>& GetRegions() const;
+  int GetSecondsBetweenCheckpoints() const;
+  int GetSecondsBetweenReports() const;
   VariantType GetVariantType() const;
+  bool ShouldAnalyzeAltAllele(const Event& event, int alt_allele) const;
+  bool ShouldAnalyzeCall(const Event& event,
+      const GenotypingResults& results) const;
   bool ShouldAnalyzeVariant(const Event& event) const;
 private:
 
@@ -41,9 +66,24 @@ private:
 
   VariantType variant_type_;
   bool is_pindel_;
+  bool is_sweeping_;
+  bool is_calibrating_;
   double min_confidence_;
   int min_size_;
   int max_size_;
+  int number_of_threads_;
+  PhaseOrder phase_order_;
+  int seconds_between_reports_;
+  int seconds_between_checkpoints_;
+  std::string name_of_output_file_;
+  std::string name_of_bed_file_;
+  std::string name_of_cache_file_;
+  std::string name_of_ped_file_;
+  std::string name_of_report_file_;
+  std::string name_of_checkpoint_file_;
+  std::string name_of_configurations_file_;
+  std::string name_of_resume_file_;
+  std::vector<std::string> regions_;
   std::map<std::string, VariantType> string_to_variant_type_map_;
 };
 
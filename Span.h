@@ -0,0 +1,74 @@
+/*
+ * Span.h
+ *
+ * A non-owning view on a piece of text (a pointer plus a length), so that the
+ * columns and fields of a VCF line can be handed around without copying them
+ * into std::strings. The functions are defined in the header as they are
+ * called for every field of every record.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SPAN_H_
+#define SPAN_H_
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+class Span {
+public:
+  Span() : data_(NULL), size_(0) {}
+  Span(const char* data, size_t size) : data_(data), size_(size) {}
+  Span(const char* begin, const char* end) : data_(begin),
+      size_(end - begin) {}
+  Span(const std::string& str) : data_(str.data()), size_(str.size()) {}
+
+  const char* begin() const { return data_; }
+  const char* end() const { return data_ + size_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  char operator[](size_t index) const { return data_[index]; }
+
+  /** Is this span equal to the given (zero-terminated) text? **/
+  bool Equals(const char* text) const {
+    size_t text_length = strlen(text);
+    return (text_length == size_) && (memcmp(data_, text, size_) == 0);
+  }
+
+  /** Returns the position of the first occurrence of 'ch', or size() if the
+   * span does not contain 'ch'. **/
+  size_t Find(char ch) const {
+    const void* found = (size_ == 0) ? NULL : memchr(data_, ch, size_);
+    return (found == NULL) ?
+        size_ : static_cast<const char*>(found) - data_;
+  }
+
+  /** The part of the span before the first 'ch' (the entire span if there is
+   * no 'ch'). **/
+  Span Until(char ch) const {
+    return Span(data_, Find(ch));
+  }
+
+  /** The part of the span after the first 'ch' (empty if there is no
+   * 'ch'). **/
+  Span After(char ch) const {
+    size_t position = Find(ch);
+    return (position == size_) ?
+        Span(end(), end()) : Span(data_ + position + 1, end());
+  }
+
+  std::string ToString() const { return std::string(data_, size_); }
+
+private:
+  const char* data_;
+  size_t size_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const Span& span) {
+  os.write(span.begin(), span.size());
+  return os;
+}
+
+#endif /* SPAN_H_ */
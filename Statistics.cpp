@@ -0,0 +1,178 @@
+/*
+ * Statistics.cpp
+ *
+ * The counts gathered while analyzing (part of) a VCF file: how many events,
+ * calls and trios of each kind were seen, and the qualities per VAF,
+ * coverage and event type. Each thread fills its own Statistics object; they
+ * are merged when all threads are done.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "Statistics.h"
+
+/** Constructor; all counts start at zero. **/
+RegionCounts::RegionCounts() : event_count(0), all_homref(0),
+    mendelian_correct(0), mendelian_error(0), unknown_count(0) {
+}
+
+/** Adds the counts of 'other' to these. **/
+void RegionCounts::Merge(const RegionCounts& other) {
+  event_count += other.event_count;
+  all_homref += other.all_homref;
+  mendelian_correct += other.mendelian_correct;
+  mendelian_error += other.mendelian_error;
+  unknown_count += other.unknown_count;
+}
+
+/** Constructor; all counts start at zero. **/
+Statistics::Statistics() {
+  unknown_count = 0;
+  mendelian_correct = 0;
+  mendelian_error = 0;
+  all_genotyped = 0;
+  all_homref = 0;
+  event_count = 0;
+  for (int index = 0; index < 4; ++index) {
+    trio_count[index] = 0;
+  }
+  unknown_calls = 0;
+  homref_calls = 0;
+  variant_calls = 0;
+  unstored_allele_records = 0;
+}
+
+/** Adds the counts of 'other' to these. As all counts are integers, the
+ * result does not depend on the order in which partial results are merged. **/
+void Statistics::Merge(const Statistics& other) {
+  for (int index = 0; index <= NUM_VAF_BINS; ++index) {
+    vaf_qualities[index].Merge(other.vaf_qualities[index]);
+  }
+  for (int index = 0; index <= MAX_SUPPORT / COVERAGE_RESOLUTION; ++index) {
+    coverage_qualities[index].Merge(other.coverage_qualities[index]);
+  }
+  for (int index = 0; index < NUMBER_OF_EVENT_TYPES; ++index) {
+    eventtype_qualities[index].Merge(other.eventtype_qualities[index]);
+  }
+
+  unknown_count += other.unknown_count;
+  mendelian_correct += other.mendelian_correct;
+  mendelian_error += other.mendelian_error;
+  all_genotyped += other.all_genotyped;
+  all_homref += other.all_homref;
+  event_count += other.event_count;
+  for (int index = 0; index < 4; ++index) {
+    trio_count[index] += other.trio_count[index];
+  }
+  unknown_calls += other.unknown_calls;
+  homref_calls += other.homref_calls;
+  variant_calls += other.variant_calls;
+  unstored_allele_records += other.unstored_allele_records;
+
+  mendelian_errors.Merge(other.mendelian_errors);
+  confidence_sweep.Merge(other.confidence_sweep);
+
+  if (region_counts.size() < other.region_counts.size()) {
+    region_counts.resize(other.region_counts.size());
+  }
+  for (size_t index = 0; index < other.region_counts.size(); ++index) {
+    region_counts[index].Merge(other.region_counts[index]);
+  }
+}
+
+/** Gets the counts that are also kept per region. **/
+RegionCounts Statistics::GetRegionCounts() const {
+  RegionCounts counts;
+  counts.event_count = event_count;
+  counts.all_homref = all_homref;
+  counts.mendelian_correct = mendelian_correct;
+  counts.mendelian_error = mendelian_error;
+  counts.unknown_count = unknown_count;
+  return counts;
+}
+
+/** Adds what has been counted since 'counts_before' was taken (with
+ * GetRegionCounts) to the counts of the region. **/
+void Statistics::AddToRegion(int region_index,
+    const RegionCounts& counts_before) {
+  if (region_counts.size() <= static_cast<size_t>(region_index)) {
+    region_counts.resize(region_index + 1);
+  }
+  RegionCounts& counts = region_counts[region_index];
+  counts.event_count += event_count - counts_before.event_count;
+  counts.all_homref += all_homref - counts_before.all_homref;
+  counts.mendelian_correct += mendelian_correct -
+      counts_before.mendelian_correct;
+  counts.mendelian_error += mendelian_error - counts_before.mendelian_error;
+  counts.unknown_count += unknown_count - counts_before.unknown_count;
+}
+
+/** Reads the counts as written by WriteTo, replacing the current ones. **/
+void Statistics::ReadFrom(std::istream& is) {
+  is >> unknown_count >> mendelian_correct >> mendelian_error >>
+      all_genotyped >> all_homref >> event_count;
+  for (int index = 0; index < 4; ++index) {
+    is >> trio_count[index];
+  }
+  is >> unknown_calls >> homref_calls >> variant_calls >>
+      unstored_allele_records;
+  for (int index = 0; index <= NUM_VAF_BINS; ++index) {
+    vaf_qualities[index].ReadFrom(is);
+  }
+  for (int index = 0; index <= MAX_SUPPORT / COVERAGE_RESOLUTION; ++index) {
+    coverage_qualities[index].ReadFrom(is);
+  }
+  for (int index = 0; index < NUMBER_OF_EVENT_TYPES; ++index) {
+    eventtype_qualities[index].ReadFrom(is);
+  }
+  mendelian_errors.ReadFrom(is);
+  confidence_sweep.ReadFrom(is);
+  size_t number_of_regions = 0;
+  is >> number_of_regions;
+  region_counts.assign(is ? number_of_regions : 0, RegionCounts());
+  for (size_t index = 0; index < region_counts.size(); ++index) {
+    RegionCounts& counts = region_counts[index];
+    is >> counts.event_count >> counts.all_homref >>
+        counts.mendelian_correct >> counts.mendelian_error >>
+        counts.unknown_count;
+  }
+}
+
+/** Writes all counts as whitespace-separated numbers, so they can be read
+ * back with ReadFrom. **/
+void Statistics::WriteTo(std::ostream& os) const {
+  os << unknown_count << " " << mendelian_correct << " " << mendelian_error <<
+      " " << all_genotyped << " " << all_homref << " " << event_count;
+  for (int index = 0; index < 4; ++index) {
+    os << " " << trio_count[index];
+  }
+  os << " " << unknown_calls << " " << homref_calls << " " << variant_calls <<
+      " " << unstored_allele_records;
+  os << "\n";
+  for (int index = 0; index <= NUM_VAF_BINS; ++index) {
+    os << " ";
+    vaf_qualities[index].WriteTo(os);
+  }
+  os << "\n";
+  for (int index = 0; index <= MAX_SUPPORT / COVERAGE_RESOLUTION; ++index) {
+    os << " ";
+    coverage_qualities[index].WriteTo(os);
+  }
+  os << "\n";
+  for (int index = 0; index < NUMBER_OF_EVENT_TYPES; ++index) {
+    os << " ";
+    eventtype_qualities[index].WriteTo(os);
+  }
+  os << "\n";
+  mendelian_errors.WriteTo(os);
+  os << "\n";
+  confidence_sweep.WriteTo(os);
+  os << "\n" << region_counts.size();
+  for (size_t index = 0; index < region_counts.size(); ++index) {
+    const RegionCounts& counts = region_counts[index];
+    os << "\n" << counts.event_count << " " << counts.all_homref << " " <<
+        counts.mendelian_correct << " " << counts.mendelian_error << " " <<
+        counts.unknown_count;
+  }
+  os << "\n";
+}
@@ -0,0 +1,76 @@
+/*
+ * Statistics.h
+ *
+ * The counts gathered while analyzing (part of) a VCF file: how many events,
+ * calls and trios of each kind were seen, and the qualities per VAF,
+ * coverage and event type. Each thread fills its own Statistics object; they
+ * are merged when all threads are done.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef STATISTICS_H_
+#define STATISTICS_H_
+
+#include <iostream>
+#include <vector>
+
+#include "ConfidenceSweep.h"
+#include "Event.h"
+#include "MendelianErrorMap.h"
+#include "Quality.h"
+
+// the counts that are reported per region
+struct RegionCounts {
+  RegionCounts();
+
+  void Merge(const RegionCounts& other);
+
+  int event_count;
+  int all_homref;
+  int mendelian_correct;
+  int mendelian_error;
+  int unknown_count;
+};
+
+struct Statistics {
+  Statistics();
+
+  void AddToRegion(int region_index, const RegionCounts& counts_before);
+  RegionCounts GetRegionCounts() const;
+  void Merge(const Statistics& other);
+  void ReadFrom(std::istream& is);
+  void WriteTo(std::ostream& os) const;
+
+  static const int NUM_VAF_BINS = 40;
+  static const int COVERAGE_RESOLUTION = 5;
+  static const int MAX_SUPPORT = 200;
+
+  // a VAF of exactly 1.0 falls into bin NUM_VAF_BINS
+  Quality vaf_qualities[NUM_VAF_BINS + 1];
+  Quality coverage_qualities[1 + MAX_SUPPORT / COVERAGE_RESOLUTION];
+  Quality eventtype_qualities[NUMBER_OF_EVENT_TYPES];
+
+  int unknown_count;
+  int mendelian_correct;
+  int mendelian_error;
+  int all_genotyped;
+  int all_homref;
+  int event_count;
+  int trio_count[4];
+  int unknown_calls;
+  int homref_calls;
+  int variant_calls;
+  // records with more alt alleles than Event keeps, whatever the filters
+  int unstored_allele_records;
+
+  MendelianErrorMap mendelian_errors;
+
+  // the counts per minimal confidence (if a sweep is asked for)
+  ConfidenceSweep confidence_sweep;
+
+  // per region (if the analysis is restricted to regions)
+  std::vector<RegionCounts> region_counts;
+};
+
+#endif /* STATISTICS_H_ */
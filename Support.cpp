@@ -11,65 +11,146 @@
 
 #include "Support.h"
 
-#include <cstdlib>
 #include <string>
+#include <type_traits>
 
 #include "Utilities.h"
 
-std::ostream& operator<<(std::ostream& os, Support support) {
-  for (size_t index = 0; index < support.supports_.size(); ++index) {
-    os << support.supports_[index];
-    if (index < support.supports_.size() - 1) {
-      os << ",";
+static_assert(std::is_trivially_copyable<Support>::value,
+    "Support should be copyable with memcpy");
+
+std::ostream& operator<<(std::ostream& os, const Support& support) {
+  std::string support_as_string;
+  support.AppendTo(&support_as_string);
+  os << support_as_string;
+  return os;
+}
+
+/** Appends the support counts to 'text', separated by commas. **/
+void Support::AppendTo(std::string* text) const {
+  for (int index = 0; index < number_of_alleles_; ++index) {
+    Utilities::AppendInteger(supports_[index], text);
+    if (index < number_of_alleles_ - 1) {
+      text->push_back(',');
     }
   }
-  return os;
 }
 
 /** Constructor. Takes the 'miscellaneous info' part of the genotype string.
  * So if the full VCF genotyping string is "0/1:15,25", then the constructor
  * takes "15,25" as input. **/
 Support::Support(const std::string& support_string) {
-  std::vector<std::string> supports_as_strings = Utilities::Split(support_string,',');
-  for (size_t index = 0; index < supports_as_strings.size(); ++index) {
-    supports_.push_back(atoi(supports_as_strings[index].c_str()));
+  Parse(Span(support_string));
+}
+
+/** Constructor. Takes the support counts as a span of text ("15,25"), usually
+ * pointing directly into a line of the VCF file. **/
+Support::Support(const Span& support) {
+  Parse(support);
+}
+
+/** Constructor. Takes the support counts themselves, as kept by a record
+ * cache for example. **/
+Support::Support(const int* counts, int number_of_counts) {
+  if (number_of_counts > MAX_ALLELES) {
+    Utilities::Require(false, "Support error: too many alleles.");
+  }
+  number_of_alleles_ = number_of_counts;
+  for (int index = 0; index < number_of_counts; ++index) {
+    supports_[index] = counts[index];
   }
+  Summarize();
 }
 
 /** To allow Support to be a regular data member of another class. **/
-Support::Support() {
+Support::Support() : number_of_alleles_(0), total_support_(0), vaf_(-1) {
 }
 
-/** returns the Variant Allele Frequency. **/
+/** Reads the comma-separated counts. Like atoi, every count is read up to
+ * the first character that is not a digit, and a count without digits
+ * (such as ".") is 0. Pindel's refcount of -1 is kept as is. **/
+void Support::Parse(const Span& support) {
+  number_of_alleles_ = 0;
+  const char* position = support.begin();
+  const char* end = support.end();
+  while (true) {
+    if (number_of_alleles_ == MAX_ALLELES) {
+      Utilities::Require(false, "Support::Parse error: too many alleles in " +
+          support.ToString());
+    }
+    bool is_negative = false;
+    if (position != end && (*position == '-' || *position == '+')) {
+      is_negative = (*position == '-');
+      ++position;
+    }
+    int count = 0;
+    while (position != end && *position >= '0' && *position <= '9') {
+      count = 10 * count + (*position - '0');
+      ++position;
+    }
+    count = is_negative ? -count : count;
+    supports_[number_of_alleles_++] = count;
+    while (position != end && *position != ',') {
+      ++position;
+    }
+    if (position == end) {
+      break;
+    }
+    ++position; // skip the ','
+  }
+  Summarize();
+}
+
+/** Calculates the total support and the VAF from the counts. **/
+void Support::Summarize() {
+  total_support_ = 0;
+  for (int index = 0; index < number_of_alleles_; ++index) {
+    total_support_ += supports_[index];
+  }
+  vaf_ = -1;
+  if (number_of_alleles_ == 2 && total_support_ > 0) {
+    int alt_coverage = total_support_ - supports_[0];
+    vaf_ = alt_coverage / static_cast<double>(total_support_);
+  }
+}
+
+/** returns the Variant Allele Frequency; -1 if it is not known, which is
+ * the case unless there are counts for exactly two alleles and they are not
+ * both 0. **/
 double Support::GetVaf() const {
-  Utilities::Require(supports_.size() == 2,
-      "Support::GetVaf error: there need to be two alleles to recover the"
-      "variant allele frequency.");
-  /*Utilities::Require(GetTotalSupport() > 0,
-      "Support::GetVaf error: the total support must be greater than zero");*/
-  int total_support = GetTotalSupport();
-  if (total_support <= 0) {
+  return vaf_;
+}
+
+/** returns the fraction of the reads that supports one allele (1 for the
+ * first alt allele); -1 if it is not known, which is the case unless the
+ * allele has a count and the counts add up to more than 0. **/
+double Support::GetVaf(int allele) const {
+  if (allele < 0 || allele >= number_of_alleles_ || total_support_ <= 0) {
     return -1;
   }
+  return supports_[allele] / static_cast<double>(total_support_);
+}
+
 
-  int alt_coverage = total_support - supports_[0];
-  return alt_coverage / static_cast<double>(total_support);
+/** Returns the number of alleles that have a count. **/
+int Support::GetNumberOfAlleles() const {
+  return number_of_alleles_;
 }
 
+/** Returns the count of an allele (0 is the reference). **/
+int Support::GetCount(int allele) const {
+  return supports_[allele];
+}
 
 /** Returns the total support for all alleles at a certain position. **/
 int Support::GetTotalSupport() const {
-  int total_support = 0;
-  for (size_t index = 0; index < supports_.size(); ++index) {
-    total_support += supports_[index];
-  }
-  return total_support;
+  return total_support_;
 }
 
 /** In some cases, the support provided by Pindel indicates that we actually
  * do not know the genotype, despite an official genotype call. **/
 bool Support::IndicatesUnknownGenotype() const {
-  if (supports_.size() == 0) {
+  if (number_of_alleles_ == 0) {
     return true;
   }
   else if (GetTotalSupport() == 0) {
@@ -84,12 +165,7 @@ bool Support::IndicatesUnknownGenotype() const {
   }
 }
 
-Support::~Support() {
-  // TODO Auto-generated destructor stub
-}
-
 Support Support::NoSupport() {
   Support dummy_support("");
   return dummy_support;
 }
-
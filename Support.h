@@ -12,25 +12,43 @@
 #ifndef SUPPORT_H_
 #define SUPPORT_H_
 
+#include <iostream>
 #include <string>
-#include <vector>
 
+#include "Span.h"
+
+/** The counts are stored inside the object, and the total support and the
+ * VAF are calculated once, when the counts are read. The VAFs of the
+ * individual alleles of multi-allelic sites are calculated when asked. **/
 class Support {
-friend std::ostream& operator<<(std::ostream& os, Support support);
+friend std::ostream& operator<<(std::ostream& os, const Support& support);
 
 
 public:
   Support(const std::string& raw_genotype);
+  Support(const Span& support);
+  Support(const int* counts, int number_of_counts);
   Support();
-  virtual ~Support();
 
+  void AppendTo(std::string* text) const;
+  int GetCount(int allele) const;
+  int GetNumberOfAlleles() const;
   int GetTotalSupport() const;
   double GetVaf() const;
+  double GetVaf(int allele) const;
   bool IndicatesUnknownGenotype() const;
   static Support NoSupport();
 
+  static const int MAX_ALLELES = 16;
+
 private:
-  std::vector<int> supports_;
+  void Parse(const Span& support);
+  void Summarize();
+
+  int supports_[MAX_ALLELES];
+  int number_of_alleles_;
+  int total_support_;
+  double vaf_;
 };
 
 #endif /* SUPPORT_H_ */
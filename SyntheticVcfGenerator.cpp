@@ -0,0 +1,224 @@
+/*
+ * SyntheticVcfGenerator.cpp
+ *
+ * Generates a VCF file of trios with random variants and genotypes, in the
+ * style of pindel or of GATK. The same options (including the seed) always
+ * give the same file, so that benchmarks can be repeated offline.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "SyntheticVcfGenerator.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "Utilities.h"
+
+namespace {
+
+// the chance that a sample has no genotype call
+const double MISSING_CALL_RATE = 0.02;
+// small indels change 1 to this many bases, structural variants more
+const int MAX_INDEL_SIZE = 20;
+const int MAX_SV_SIZE = 2000;
+const long long CHROMOSOME_LENGTH = 200000000;
+
+const char* const ALT_ALLELE_COUNTS_AS_GENOTYPES[] = { "0/0", "0/1", "1/1" };
+
+const char BASES[] = "ACGT";
+const int NUMBER_OF_BASES = 4;
+
+} // namespace
+
+/** Constructor; sets the defaults: 100,000 pindel records of 3 trios. **/
+SyntheticVcfOptions::SyntheticVcfOptions() : number_of_records(100000),
+    number_of_trios(3), snp_weight(0.7), indel_weight(0.2), sv_weight(0.1),
+    is_pindel(true), mendelian_error_rate(0.02), seed(1) {
+}
+
+/** Constructor. **/
+SyntheticVcfGenerator::SyntheticVcfGenerator(
+    const SyntheticVcfOptions& options) : options_(options),
+    random_(options.seed), number_of_records_made_(0), chromosome_(1),
+    position_(0) {
+  Utilities::Require(options_.number_of_trios > 0,
+      "SyntheticVcfGenerator error: at least one trio is needed.");
+  Utilities::Require(options_.snp_weight >= 0 && options_.indel_weight >= 0 &&
+      options_.sv_weight >= 0 && options_.snp_weight + options_.indel_weight +
+      options_.sv_weight > 0,
+      "SyntheticVcfGenerator error: invalid mix of variant types.");
+}
+
+/** Appends the meta-information lines and the #CHROM line. **/
+void SyntheticVcfGenerator::AppendHeader(std::string* vcf) const {
+  vcf->append("##fileformat=VCFv4.2\n"
+      "##source=SyntheticVcfGenerator\n"
+      "##FORMAT=<ID=GT,Number=1,Type=String,Description=\"Genotype\">\n"
+      "##FORMAT=<ID=AD,Number=R,Type=Integer,Description=\"Allelic depths\">"
+      "\n");
+  if (!options_.is_pindel) {
+    vcf->append("##FORMAT=<ID=DP,Number=1,Type=Integer,Description=\"Read "
+        "depth\">\n"
+        "##FORMAT=<ID=GQ,Number=1,Type=Integer,Description=\"Genotype "
+        "quality\">\n"
+        "##FORMAT=<ID=PL,Number=G,Type=Integer,Description=\"Phred-scaled "
+        "genotype likelihoods\">\n");
+  }
+  vcf->append("#CHROM\tPOS\tID\tREF\tALT\tQUAL\tFILTER\tINFO\tFORMAT");
+  for (int trio_index = 1; trio_index <= options_.number_of_trios;
+      ++trio_index) {
+    std::stringstream names;
+    names << "\ttrio" << trio_index << "_father\ttrio" << trio_index <<
+        "_mother\ttrio" << trio_index << "_child";
+    vcf->append(names.str());
+  }
+  vcf->push_back('\n');
+}
+
+/** Appends the next record; returns false (appending nothing) once all
+ * records have been made. **/
+bool SyntheticVcfGenerator::AppendRecord(std::string* vcf) {
+  if (number_of_records_made_ == options_.number_of_records) {
+    return false;
+  }
+  ++number_of_records_made_;
+  position_ += 1 + GetRandomNumber(1000);
+  if (position_ > CHROMOSOME_LENGTH) {
+    ++chromosome_;
+    position_ = 1;
+  }
+  std::stringstream start_of_record;
+  start_of_record << "chr" << chromosome_ << '\t' << position_ << "\t.\t";
+  vcf->append(start_of_record.str());
+  AppendAlleles(vcf);
+  vcf->append("\t60\tPASS\t.\t");
+  vcf->append(options_.is_pindel ? "GT:AD" : "GT:AD:DP:GQ:PL");
+
+  for (int trio_index = 0; trio_index < options_.number_of_trios;
+      ++trio_index) {
+    int father = GetRandomNumber(100) < 60 ? 0 :
+        (GetRandomNumber(100) < 70 ? 1 : 2);
+    int mother = GetRandomNumber(100) < 60 ? 0 :
+        (GetRandomNumber(100) < 70 ? 1 : 2);
+    int child = InheritAllele(father) + InheritAllele(mother);
+    if (GetRandomFraction() < options_.mendelian_error_rate) {
+      // a count of alt alleles that the parents cannot give, if there is one
+      int lowest_possible = (father == 2 ? 1 : 0) + (mother == 2 ? 1 : 0);
+      int highest_possible = (father == 0 ? 0 : 1) + (mother == 0 ? 0 : 1);
+      if (lowest_possible > 0) {
+        child = 0;
+      }
+      else if (highest_possible < 2) {
+        child = 2;
+      }
+    }
+    AppendSample(father, vcf);
+    AppendSample(mother, vcf);
+    AppendSample(child, vcf);
+  }
+  vcf->push_back('\n');
+  return true;
+}
+
+/** Appends the REF and ALT columns of a SNP, a small indel or a structural
+ * variant (a deletion, insertion or replacement). The ALT base of a SNP
+ * differs from the REF base; the alleles of the other variants start with
+ * the same (padding) base, as in a VCF file. **/
+void SyntheticVcfGenerator::AppendAlleles(std::string* vcf) {
+  double type = GetRandomFraction() * (options_.snp_weight +
+      options_.indel_weight + options_.sv_weight);
+  int ref_size = 1;
+  int alt_size = 1;
+  if (type >= options_.snp_weight) {
+    int max_size = (type < options_.snp_weight + options_.indel_weight) ?
+        MAX_INDEL_SIZE : MAX_SV_SIZE;
+    int size = 1 + GetRandomNumber(max_size);
+    switch (GetRandomNumber(max_size == MAX_SV_SIZE ? 3 : 2)) {
+    case 0:
+      ref_size += size;
+      break;
+    case 1:
+      alt_size += size;
+      break;
+    default:
+      ref_size += size;
+      alt_size += 1 + GetRandomNumber(max_size);
+    }
+  }
+  int first_base = GetRandomNumber(NUMBER_OF_BASES);
+  vcf->push_back(BASES[first_base]);
+  AppendBases(ref_size - 1, vcf);
+  vcf->push_back('\t');
+  if (ref_size == 1 && alt_size == 1) {
+    // one of the other three bases
+    vcf->push_back(BASES[(first_base + 1 +
+        GetRandomNumber(NUMBER_OF_BASES - 1)) % NUMBER_OF_BASES]);
+  }
+  else {
+    vcf->push_back(BASES[first_base]);
+    AppendBases(alt_size - 1, vcf);
+  }
+}
+
+/** Appends random bases. **/
+void SyntheticVcfGenerator::AppendBases(int number_of_bases,
+    std::string* vcf) {
+  for (int index = 0; index < number_of_bases; ++index) {
+    vcf->push_back(BASES[GetRandomNumber(NUMBER_OF_BASES)]);
+  }
+}
+
+/** Appends a sample column with the given number of alt alleles (0, 1 or
+ * 2), with read counts that fit it; some samples are not called at all. **/
+void SyntheticVcfGenerator::AppendSample(int number_of_alt_alleles,
+    std::string* vcf) {
+  bool is_called = GetRandomFraction() >= MISSING_CALL_RATE;
+  int depth = is_called ? 5 + GetRandomNumber(55) : 0;
+  int alt_depth = 0;
+  if (number_of_alt_alleles == 1) {
+    alt_depth = depth / 4 + GetRandomNumber(depth / 2 + 1);
+  }
+  else if (number_of_alt_alleles == 2 && depth > 0) {
+    alt_depth = std::max(0, depth - GetRandomNumber(2));
+  }
+  else if (depth > 0) {
+    alt_depth = GetRandomNumber(2);
+  }
+
+  std::stringstream sample;
+  sample << '\t' << (is_called ?
+      ALT_ALLELE_COUNTS_AS_GENOTYPES[number_of_alt_alleles] : "./.") <<
+      ':' << depth - alt_depth << ',' << alt_depth;
+  if (!options_.is_pindel) {
+    if (is_called) {
+      sample << ':' << depth << ':' << 20 + GetRandomNumber(80) << ":" <<
+          (number_of_alt_alleles == 0 ? 0 : 10 * depth) << ',' <<
+          (number_of_alt_alleles == 1 ? 0 : 3 * depth) << ',' <<
+          (number_of_alt_alleles == 2 ? 0 : 10 * depth);
+    }
+    else {
+      sample << ":0:.:.";
+    }
+  }
+  vcf->append(sample.str());
+}
+
+/** Returns a random number from 0 up to (but not including) 'maximum'.
+ * Unlike the distributions of <random>, this gives the same numbers with
+ * every standard library. **/
+int SyntheticVcfGenerator::GetRandomNumber(int maximum) {
+  return static_cast<int>(random_() % maximum);
+}
+
+/** Returns a random number in [0, 1). **/
+double SyntheticVcfGenerator::GetRandomFraction() {
+  return random_() / 4294967296.0;
+}
+
+/** Returns the number of alt alleles (0 or 1) that a parent with the given
+ * number of alt alleles passes on. **/
+int SyntheticVcfGenerator::InheritAllele(int number_of_alt_alleles) {
+  return number_of_alt_alleles == 1 ? GetRandomNumber(2) :
+      number_of_alt_alleles / 2;
+}
@@ -0,0 +1,56 @@
+/*
+ * SyntheticVcfGenerator.h
+ *
+ * Generates a VCF file of trios with random variants and genotypes, in the
+ * style of pindel or of GATK. The same options (including the seed) always
+ * give the same file, so that benchmarks can be repeated offline.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SYNTHETICVCFGENERATOR_H_
+#define SYNTHETICVCFGENERATOR_H_
+
+#include <random>
+#include <string>
+
+// what the generated VCF file should look like
+struct SyntheticVcfOptions {
+  SyntheticVcfOptions();
+
+  long long number_of_records;
+  int number_of_trios;
+  // the relative frequencies of SNPs, small indels and structural variants
+  double snp_weight;
+  double indel_weight;
+  double sv_weight;
+  // pindel (GT:AD) or GATK (GT:AD:DP:GQ:PL) sample columns
+  bool is_pindel;
+  // the fraction of trios of which the child does not follow Mendel's laws
+  double mendelian_error_rate;
+  unsigned int seed;
+};
+
+class SyntheticVcfGenerator {
+public:
+  explicit SyntheticVcfGenerator(const SyntheticVcfOptions& options);
+
+  void AppendHeader(std::string* vcf) const;
+  bool AppendRecord(std::string* vcf);
+
+private:
+  void AppendAlleles(std::string* vcf);
+  void AppendBases(int number_of_bases, std::string* vcf);
+  void AppendSample(int number_of_alt_alleles, std::string* vcf);
+  int GetRandomNumber(int maximum);
+  double GetRandomFraction();
+  int InheritAllele(int number_of_alt_alleles);
+
+  SyntheticVcfOptions options_;
+  std::mt19937 random_;
+  long long number_of_records_made_;
+  int chromosome_;
+  long long position_;
+};
+
+#endif /* SYNTHETICVCFGENERATOR_H_ */
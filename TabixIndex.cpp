@@ -0,0 +1,258 @@
+/*
+ * TabixIndex.cpp
+ *
+ * Reads the tabix (.tbi) or CSI (.csi) index of a BGZF-compressed VCF file,
+ * and tells which chunks of the file can contain records in a given region,
+ * so that only those have to be decompressed and parsed.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "TabixIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Utilities.h"
+
+namespace {
+
+const int TBI_MIN_SHIFT = 14;
+const int TBI_DEPTH = 5;
+
+/** Reads the little-endian numbers and texts of an index, aborting if the
+ * index ends too early. **/
+class IndexParser {
+public:
+  IndexParser(const std::string& contents) : contents_(contents),
+      position_(0) {}
+
+  bool IsAtEnd() const { return position_ == contents_.size(); }
+
+  unsigned long long ReadNumber(int size) {
+    Utilities::Require(contents_.size() - position_ >= static_cast<size_t>(
+        size), "TabixIndex error: the index file is truncated.");
+    unsigned long long value = 0;
+    for (int index = size - 1; index >= 0; --index) {
+      value = (value << 8) |
+          static_cast<unsigned char>(contents_[position_ + index]);
+    }
+    position_ += size;
+    return value;
+  }
+
+  int ReadInt() { return static_cast<int>(ReadNumber(4)); }
+
+  std::string ReadText(size_t size) {
+    Utilities::Require(contents_.size() - position_ >= size,
+        "TabixIndex error: the index file is truncated.");
+    position_ += size;
+    return contents_.substr(position_ - size, size);
+  }
+
+private:
+  const std::string& contents_;
+  size_t position_;
+};
+
+/** Reads a file that is (BGZF-)compressed, like an index, into 'contents'.
+ * Returns false if the file does not exist. **/
+bool ReadCompressedFile(const std::string& name_of_file,
+    std::string* contents) {
+  int file_descriptor = open(name_of_file.c_str(), O_RDONLY);
+  if (file_descriptor < 0) {
+    return false;
+  }
+  {
+    BgzfReader reader(file_descriptor, "", 1);
+    char buffer[1 << 16];
+    size_t bytes_read;
+    while ((bytes_read = reader.Read(buffer, sizeof(buffer))) > 0) {
+      contents->append(buffer, bytes_read);
+    }
+  }
+  close(file_descriptor);
+  return true;
+}
+
+/** Adds the numbers of all bins that overlap the 0-based, half-open range
+ * [begin, end) to 'bins', for a binning scheme with the given minimal bin
+ * size (2^min_shift) and number of levels. **/
+void GetBinsOfRange(long long begin, long long end, int min_shift, int depth,
+    std::vector<unsigned int>* bins) {
+  --end;
+  int shift = min_shift + 3 * depth;
+  unsigned int first_bin_of_level = 0;
+  for (int level = 0; level <= depth; ++level) {
+    for (long long bin = first_bin_of_level + (begin >> shift);
+        bin <= first_bin_of_level + (end >> shift); ++bin) {
+      bins->push_back(bin);
+    }
+    first_bin_of_level += 1u << (3 * level);
+    shift -= 3;
+  }
+}
+
+} // namespace
+
+/** Constructor; loads 'name_of_vcf_file'.tbi or, failing that, .csi if
+ * either exists. **/
+TabixIndex::TabixIndex(const std::string& name_of_vcf_file) :
+    is_loaded_(false), is_csi_(false), min_shift_(TBI_MIN_SHIFT),
+    depth_(TBI_DEPTH) {
+  is_loaded_ = Load(name_of_vcf_file + ".tbi") ||
+      Load(name_of_vcf_file + ".csi");
+}
+
+/** Reads the index file; returns false if there is no such file. **/
+bool TabixIndex::Load(const std::string& name_of_index_file) {
+  std::string contents;
+  if (!ReadCompressedFile(name_of_index_file, &contents)) {
+    return false;
+  }
+  name_of_index_file_ = name_of_index_file;
+  IndexParser parser(contents);
+  std::string magic = parser.ReadText(4);
+  is_csi_ = (magic == std::string("CSI\1", 4));
+  Utilities::Require(is_csi_ || magic == std::string("TBI\1", 4),
+      "TabixIndex error: '" + name_of_index_file + "' is not an index.");
+
+  int number_of_references = 0;
+  std::string names;
+  if (is_csi_) {
+    min_shift_ = parser.ReadInt();
+    depth_ = parser.ReadInt();
+    int auxiliary_size = parser.ReadInt();
+    // the auxiliary data holds the tabix header, including the names
+    Utilities::Require(auxiliary_size >= 28,
+        "TabixIndex error: the CSI index has no sequence names.");
+    std::string auxiliary_data = parser.ReadText(auxiliary_size);
+    IndexParser auxiliary_parser(auxiliary_data);
+    auxiliary_parser.ReadText(24);
+    names = auxiliary_parser.ReadText(auxiliary_parser.ReadInt());
+    number_of_references = parser.ReadInt();
+  }
+  else {
+    number_of_references = parser.ReadInt();
+    // format, columns of sequence, begin and end, meta character, skip
+    parser.ReadText(24);
+    names = parser.ReadText(parser.ReadInt());
+  }
+
+  size_t start_of_name = 0;
+  for (int reference_id = 0; reference_id < number_of_references &&
+      start_of_name < names.size(); ++reference_id) {
+    size_t end_of_name = std::min(names.find('\0', start_of_name),
+        names.size());
+    reference_ids_[names.substr(start_of_name, end_of_name - start_of_name)] =
+        reference_id;
+    start_of_name = end_of_name + 1;
+  }
+
+  references_.resize(number_of_references);
+  for (int reference_id = 0; reference_id < number_of_references;
+      ++reference_id) {
+    Reference& reference = references_[reference_id];
+    int number_of_bins = parser.ReadInt();
+    for (int bin_index = 0; bin_index < number_of_bins; ++bin_index) {
+      unsigned int bin = parser.ReadNumber(4);
+      if (is_csi_) {
+        parser.ReadNumber(8); // the smallest offset of the bin; not used
+      }
+      int number_of_chunks = parser.ReadInt();
+      std::vector<BgzfReader::Chunk>& chunks = reference.bins[bin];
+      for (int chunk_index = 0; chunk_index < number_of_chunks;
+          ++chunk_index) {
+        BgzfReader::Chunk chunk;
+        chunk.begin = parser.ReadNumber(8);
+        chunk.end = parser.ReadNumber(8);
+        chunks.push_back(chunk);
+      }
+    }
+    if (!is_csi_) {
+      int number_of_windows = parser.ReadInt();
+      for (int window = 0; window < number_of_windows; ++window) {
+        reference.linear_index.push_back(parser.ReadNumber(8));
+      }
+    }
+  }
+  return true;
+}
+
+/** Adds the chunks of the file that may contain records overlapping
+ * 'region' to 'chunks'. **/
+void TabixIndex::AddChunks(const GenomicRegion& region,
+    std::vector<BgzfReader::Chunk>* chunks) const {
+  std::map<std::string, int>::const_iterator found =
+      reference_ids_.find(region.chromosome);
+  if (found == reference_ids_.end()) {
+    return;
+  }
+  const Reference& reference = references_[found->second];
+  long long max_position = 1LL << (min_shift_ + 3 * depth_);
+  long long begin = std::min(region.start - 1, max_position - 1);
+  long long end = std::min(region.end, max_position);
+
+  // chunks that end before the first record that can overlap the region can
+  // be skipped
+  unsigned long long min_offset = 0;
+  if (!reference.linear_index.empty()) {
+    size_t window = std::min<size_t>(begin >> min_shift_,
+        reference.linear_index.size() - 1);
+    min_offset = reference.linear_index[window];
+  }
+
+  std::vector<unsigned int> bins;
+  GetBinsOfRange(begin, end, min_shift_, depth_, &bins);
+  for (size_t bin_index = 0; bin_index < bins.size(); ++bin_index) {
+    std::unordered_map<unsigned int, std::vector<BgzfReader::Chunk> >::
+        const_iterator bin = reference.bins.find(bins[bin_index]);
+    if (bin == reference.bins.end()) {
+      continue;
+    }
+    for (size_t chunk_index = 0; chunk_index < bin->second.size();
+        ++chunk_index) {
+      if (bin->second[chunk_index].end > min_offset) {
+        chunks->push_back(bin->second[chunk_index]);
+      }
+    }
+  }
+}
+
+/** Get the name of the index file that was loaded. **/
+std::string TabixIndex::GetNameOfIndexFile() const {
+  return name_of_index_file_;
+}
+
+/** Could an index be loaded? **/
+bool TabixIndex::IsLoaded() const {
+  return is_loaded_;
+}
+
+/** Sorts the chunks and merges those that overlap or touch, so that every
+ * record is read only once. **/
+void TabixIndex::MergeChunks(std::vector<BgzfReader::Chunk>* chunks) {
+  struct ChunkBeginsEarlier {
+    bool operator()(const BgzfReader::Chunk& first,
+        const BgzfReader::Chunk& second) const {
+      return first.begin < second.begin;
+    }
+  };
+  std::sort(chunks->begin(), chunks->end(), ChunkBeginsEarlier());
+  size_t number_of_merged_chunks = 0;
+  for (size_t index = 0; index < chunks->size(); ++index) {
+    const BgzfReader::Chunk& chunk = (*chunks)[index];
+    if (number_of_merged_chunks > 0 &&
+        chunk.begin <= (*chunks)[number_of_merged_chunks - 1].end) {
+      BgzfReader::Chunk& last_chunk = (*chunks)[number_of_merged_chunks - 1];
+      last_chunk.end = std::max(last_chunk.end, chunk.end);
+    }
+    else {
+      (*chunks)[number_of_merged_chunks++] = chunk;
+    }
+  }
+  chunks->resize(number_of_merged_chunks);
+}
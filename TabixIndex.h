@@ -0,0 +1,51 @@
+/*
+ * TabixIndex.h
+ *
+ * Reads the tabix (.tbi) or CSI (.csi) index of a BGZF-compressed VCF file,
+ * and tells which chunks of the file can contain records in a given region,
+ * so that only those have to be decompressed and parsed.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef TABIXINDEX_H_
+#define TABIXINDEX_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BgzfReader.h"
+#include "RegionSet.h"
+
+class TabixIndex {
+public:
+  TabixIndex(const std::string& name_of_vcf_file);
+
+  void AddChunks(const GenomicRegion& region,
+      std::vector<BgzfReader::Chunk>* chunks) const;
+  std::string GetNameOfIndexFile() const;
+  bool IsLoaded() const;
+  static void MergeChunks(std::vector<BgzfReader::Chunk>* chunks);
+
+private:
+  // the bins of one reference sequence (chromosome), and for .tbi indices the
+  // linear index: the smallest virtual offset per window of 2^min_shift bases
+  struct Reference {
+    std::unordered_map<unsigned int, std::vector<BgzfReader::Chunk> > bins;
+    std::vector<unsigned long long> linear_index;
+  };
+
+  bool Load(const std::string& name_of_index_file);
+
+  std::string name_of_index_file_;
+  bool is_loaded_;
+  bool is_csi_;
+  int min_shift_;
+  int depth_;
+  std::map<std::string, int> reference_ids_;
+  std::vector<Reference> references_;
+};
+
+#endif /* TABIXINDEX_H_ */
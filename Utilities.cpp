@@ -12,13 +12,50 @@
 #include "Utilities.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#include <unistd.h>
+
 namespace Utilities {
 
+/** Appends a number to 'bytes' in as few bytes as needed, 7 bits per
+ * byte; the high bit of a byte is set if another byte follows. **/
+void AppendCompactNumber(unsigned int number, std::string* bytes) {
+  while (number >= 0x80) {
+    bytes->push_back(static_cast<char>((number & 0x7F) | 0x80));
+    number >>= 7;
+  }
+  bytes->push_back(static_cast<char>(number));
+}
+
+/** Appends a count, which may be negative (pindel's -1), as a compact
+ * number; small counts of either sign take a single byte. **/
+void AppendCompactCount(int count, std::string* bytes) {
+  AppendCompactNumber((static_cast<unsigned int>(count) << 1) ^
+      static_cast<unsigned int>(count >> 31), bytes);
+}
+
+/** Appends the decimal representation of 'value' to 'text'; much faster than
+ * going through a stringstream. **/
+void AppendInteger(int value, std::string* text) {
+  char digits[12];
+  int position = sizeof(digits);
+  unsigned int magnitude = (value < 0) ?
+      0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+  do {
+    digits[--position] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (value < 0) {
+    digits[--position] = '-';
+  }
+  text->append(digits + position, sizeof(digits) - position);
+}
+
 /** Gets the part of string 'str' that occurs before character 'ch'. If there
  * is no character 'ch' in the string, returns the entire string. **/
 std::string GetUntilFirstOccurrenceOf(const std::string& str,
@@ -47,6 +84,43 @@ void Require(bool requirementMet, std::string errorMessage) {
   }
 }
 
+/** Reads a number written by AppendCompactNumber, and moves past it. **/
+unsigned int ReadCompactNumber(const char** position) {
+  unsigned int number = 0;
+  int shift = 0;
+  unsigned char byte;
+  do {
+    byte = static_cast<unsigned char>(*(*position)++);
+    number |= static_cast<unsigned int>(byte & 0x7F) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return number;
+}
+
+/** Reads a count written by AppendCompactCount, and moves past it. **/
+int ReadCompactCount(const char** position) {
+  unsigned int number = ReadCompactNumber(position);
+  return static_cast<int>(number >> 1) ^ -static_cast<int>(number & 1);
+}
+
+/** Reads from 'file_descriptor' until 'size' bytes are in 'buffer' or the
+ * end of the input is reached; returns the number of bytes read. **/
+size_t ReadFully(int file_descriptor, char* buffer, size_t size) {
+  size_t total_bytes_read = 0;
+  while (total_bytes_read < size) {
+    ssize_t bytes_read = read(file_descriptor, buffer + total_bytes_read,
+        size - total_bytes_read);
+    if (bytes_read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes_read <= 0) {
+      break;
+    }
+    total_bytes_read += bytes_read;
+  }
+  return total_bytes_read;
+}
+
 /** Splits a string pre character 'ch' into a vector of strings. So 4/5/3 split
  * on '/' would yield ["4","5","3"]. **/
 std::vector<std::string> Split(const std::string& str, char separator) {
@@ -19,11 +19,18 @@
 
 namespace Utilities {
 
+void AppendCompactCount(int count, std::string* bytes);
+void AppendCompactNumber(unsigned int number, std::string* bytes);
+void AppendInteger(int value, std::string* text);
 std::string GetUntilFirstOccurrenceOf(const std::string& str, char ch);
 template<class T> bool isBetween(T value, T min_value, T max_value);
 bool isPositiveInteger(const std::string& str);
-template <class K,class V> bool MapContainsKey(std::map<K,V> the_map, K key);
+template <class K,class V> bool MapContainsKey(const std::map<K,V>& the_map,
+    const K& key);
 void Pause();
+int ReadCompactCount(const char** position);
+unsigned int ReadCompactNumber(const char** position);
+size_t ReadFully(int file_descriptor, char* buffer, size_t size);
 void Require(bool requirementMet, std::string errorMessage);
 std::vector<std::string> Split(const std::string& str, char separator);
 bool StringStartsWith(const std::string& stringToBeAssessed,
@@ -31,7 +38,10 @@ bool StringStartsWith(const std::string& stringToBeAssessed,
 std::string StringToLowerCase(const std::string& input);
 
 
-template <class K,class V> bool MapContainsKey(std::map<K,V> the_map,K key) {
+/** Does the map contain the key? Takes the map by reference; copying it
+ * would make every lookup as expensive as the size of the map. **/
+template <class K,class V> bool MapContainsKey(const std::map<K,V>& the_map,
+    const K& key) {
   //std::cout << "Key: " << key << "\n";
   return the_map.find(key) != the_map.end();
 }
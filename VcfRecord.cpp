@@ -0,0 +1,89 @@
+/*
+ * VcfRecord.cpp
+ *
+ * A tokenized VCF data line: spans for the fixed columns (CHROM up to and
+ * including FORMAT) and for each of the sample columns. The record does not
+ * own the text; it points into the line given to Parse.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "VcfRecord.h"
+
+#include <cstring>
+
+/** Constructor **/
+VcfRecord::VcfRecord() {
+}
+
+/** Destructor **/
+VcfRecord::~VcfRecord() {
+}
+
+/** Splits the fixed columns of the line. Missing fixed columns are left
+ * empty. The sample columns are left for ParseSamples. **/
+void VcfRecord::Parse(const Span& line) {
+  line_ = line;
+  samples_.clear();
+  const char* position = line.begin();
+  const char* end = line.end();
+  int column_index = 0;
+  sample_columns_ = Span(end, end);
+  while (column_index < NUMBER_OF_FIXED_COLUMNS) {
+    const char* tab = (position == end) ? NULL :
+        static_cast<const char*>(memchr(position, '\t', end - position));
+    const char* column_end = (tab == NULL) ? end : tab;
+    fixed_columns_[column_index++] = Span(position, column_end);
+    if (tab == NULL) {
+      break;
+    }
+    position = tab + 1;
+    if (column_index == NUMBER_OF_FIXED_COLUMNS) {
+      sample_columns_ = Span(position, end);
+    }
+  }
+  for (; column_index < NUMBER_OF_FIXED_COLUMNS; ++column_index) {
+    fixed_columns_[column_index] = Span(end, end);
+  }
+}
+
+/** Splits the sample columns; empty sample columns (stray tabs) are
+ * skipped. The tabs are taken from the delimiter index, which is built over
+ * all sample columns at once. The sample vector keeps its capacity from
+ * record to record, so after the first line no allocations take place. **/
+void VcfRecord::ParseSamples() {
+  delimiters_.Build(sample_columns_);
+  delimiters_.SplitAtTabs(&samples_);
+}
+
+/** Returns one of the fixed columns (CHROM, POS, ..., FORMAT). **/
+const Span& VcfRecord::GetColumn(VcfColumn column) const {
+  return fixed_columns_[column];
+}
+
+/** Returns the index of the tabs and colons in the sample columns (after
+ * ParseSamples). **/
+const DelimiterIndex& VcfRecord::GetDelimiters() const {
+  return delimiters_;
+}
+
+/** Returns CHROM up to and including FORMAT as one span, tabs included. **/
+Span VcfRecord::GetFixedColumns() const {
+  return Span(line_.begin(), fixed_columns_[kFormat].end());
+}
+
+/** Returns the entire line. **/
+const Span& VcfRecord::GetLine() const {
+  return line_;
+}
+
+/** Returns the number of sample columns (after ParseSamples). **/
+int VcfRecord::GetNumberOfSamples() const {
+  return static_cast<int>(samples_.size());
+}
+
+/** Returns the column of the sample with index 'sample_index' (0-based;
+ * after ParseSamples). **/
+const Span& VcfRecord::GetSample(int sample_index) const {
+  return samples_[sample_index];
+}
@@ -0,0 +1,53 @@
+/*
+ * VcfRecord.h
+ *
+ * A tokenized VCF data line: spans for the fixed columns (CHROM up to and
+ * including FORMAT) and for each of the sample columns. The sample columns
+ * are only split when ParseSamples is called, so records that are filtered
+ * out on their fixed columns cost little; their tabs and colons are then
+ * marked in a DelimiterIndex, which also locates the fields of each sample.
+ * The record does not own the text; it points into the line given to
+ * Parse.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef VCFRECORD_H_
+#define VCFRECORD_H_
+
+#include <vector>
+
+#include "DelimiterIndex.h"
+#include "Span.h"
+
+enum VcfColumn { kChrom, kPos, kId, kRef, kAlt, kQual, kFilter, kInfo,
+  kFormat };
+
+class VcfRecord {
+public:
+  VcfRecord();
+  virtual ~VcfRecord();
+
+  void Parse(const Span& line);
+  void ParseSamples();
+
+  const Span& GetColumn(VcfColumn column) const;
+  const DelimiterIndex& GetDelimiters() const;
+  Span GetFixedColumns() const;
+  const Span& GetLine() const;
+  int GetNumberOfSamples() const;
+  const Span& GetSample(int sample_index) const;
+
+  static const int NUMBER_OF_FIXED_COLUMNS = kFormat + 1;
+
+private:
+  Span line_;
+  Span fixed_columns_[NUMBER_OF_FIXED_COLUMNS];
+  // the text after the FORMAT column (if any), and the samples in it
+  Span sample_columns_;
+  std::vector<Span> samples_;
+  // the tabs and colons of the sample columns (after ParseSamples)
+  DelimiterIndex delimiters_;
+};
+
+#endif /* VCFRECORD_H_ */
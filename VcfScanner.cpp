@@ -0,0 +1,238 @@
+/*
+ * VcfScanner.cpp
+ *
+ * Hands out the lines of a VCF file as spans, without copying them. Regular
+ * files are memory-mapped; other inputs (pipes, for example) and
+ * gzip-compressed files are read in large blocks.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "VcfScanner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Utilities.h"
+
+/** Constructor. Maps the file into memory if it is a regular file, otherwise
+ * prepares a buffer to read it block by block. Gzip-compressed files (plain
+ * gzip or BGZF) are decompressed while they are read; BGZF blocks by
+ * 'number_of_threads' threads. **/
+VcfScanner::VcfScanner(const std::string& name_of_input_file,
+    int number_of_threads) :
+    mapped_data_(NULL), mapped_size_(0), is_exhausted_(false),
+    position_(NULL), end_(NULL), offset_(0), offset_of_line_(0),
+    decompressor_(NULL) {
+  file_descriptor_ = open(name_of_input_file.c_str(), O_RDONLY);
+  if (file_descriptor_ < 0) {
+    return;
+  }
+  struct stat file_status;
+  bool is_regular_file = fstat(file_descriptor_, &file_status) == 0 &&
+      S_ISREG(file_status.st_mode);
+  char magic[2];
+  if (is_regular_file && file_status.st_size > 0) {
+    if (pread(file_descriptor_, magic, sizeof(magic), 0) == sizeof(magic) &&
+        BgzfReader::IsGzipMagic(magic, sizeof(magic))) {
+      decompressor_ = new BgzfReader(file_descriptor_, "", number_of_threads);
+      buffer_.resize(BLOCK_SIZE);
+      position_ = &buffer_[0];
+      end_ = position_;
+      return;
+    }
+    void* mapping = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE,
+        file_descriptor_, 0);
+    if (mapping != MAP_FAILED) {
+      madvise(mapping, file_status.st_size, MADV_SEQUENTIAL);
+      mapped_data_ = static_cast<char*>(mapping);
+      mapped_size_ = file_status.st_size;
+      position_ = mapped_data_;
+      end_ = mapped_data_ + mapped_size_;
+      is_exhausted_ = true;
+      return;
+    }
+  }
+  buffer_.resize(BLOCK_SIZE);
+  position_ = &buffer_[0];
+  end_ = position_;
+  if (!is_regular_file) {
+    // a pipe cannot be rewound, so the bytes that show whether the input is
+    // compressed are either passed on or kept as the start of the text
+    size_t bytes_read = Utilities::ReadFully(file_descriptor_, magic,
+        sizeof(magic));
+    if (BgzfReader::IsGzipMagic(magic, bytes_read)) {
+      decompressor_ = new BgzfReader(file_descriptor_,
+          std::string(magic, bytes_read), number_of_threads);
+    }
+    else {
+      memcpy(&buffer_[0], magic, bytes_read);
+      end_ += bytes_read;
+    }
+  }
+}
+
+/** Constructor for scanning only the given chunks of a BGZF-compressed file
+ * (see BgzfReader). **/
+VcfScanner::VcfScanner(const std::string& name_of_input_file,
+    const std::vector<BgzfReader::Chunk>& chunks, int number_of_threads) :
+    mapped_data_(NULL), mapped_size_(0), is_exhausted_(false),
+    position_(NULL), end_(NULL), offset_(0), offset_of_line_(0),
+    decompressor_(NULL) {
+  file_descriptor_ = open(name_of_input_file.c_str(), O_RDONLY);
+  if (file_descriptor_ < 0) {
+    return;
+  }
+  decompressor_ = new BgzfReader(file_descriptor_, chunks, number_of_threads);
+  buffer_.resize(BLOCK_SIZE);
+  position_ = &buffer_[0];
+  end_ = position_;
+}
+
+/** Constructor for scanning text that is already in memory, for example a
+ * range of another scanner's mapping. The text is not copied, so it must
+ * outlive the scanner. **/
+VcfScanner::VcfScanner(const Span& text) :
+    file_descriptor_(-1), mapped_data_(NULL), mapped_size_(0),
+    is_exhausted_(true), position_(text.begin()), end_(text.end()),
+    offset_(0), offset_of_line_(0), decompressor_(NULL) {
+}
+
+/** Destructor **/
+VcfScanner::~VcfScanner() {
+  delete decompressor_;
+  if (mapped_data_ != NULL) {
+    munmap(mapped_data_, mapped_size_);
+  }
+  if (file_descriptor_ >= 0) {
+    close(file_descriptor_);
+  }
+}
+
+/** Could the input file be opened? (A scanner of text in memory always
+ * counts as open.) **/
+bool VcfScanner::IsOpen() const {
+  return file_descriptor_ >= 0 || mapped_data_ != NULL || is_exhausted_;
+}
+
+/** Returns the offset in the (decompressed) text of the start of the last
+ * line handed out by NextLine. **/
+unsigned long long VcfScanner::GetOffsetOfLine() const {
+  return offset_of_line_;
+}
+
+/** Is the input gzip-compressed? **/
+bool VcfScanner::IsCompressed() const {
+  return decompressor_ != NULL;
+}
+
+/** Is the entire input available in memory (so it can be split)? **/
+bool VcfScanner::IsMapped() const {
+  return mapped_data_ != NULL;
+}
+
+/** Splits the not yet scanned part of a mapped file into (at most)
+ * 'number_of_ranges' pieces of about equal size. Every piece starts at the
+ * beginning of a line, so the pieces can be scanned independently. **/
+std::vector<Span> VcfScanner::SplitIntoRanges(int number_of_ranges) const {
+  std::vector<Span> ranges;
+  size_t total_size = end_ - position_;
+  const char* range_start = position_;
+  for (int range_index = 1;
+      range_index <= number_of_ranges && range_start < end_; ++range_index) {
+    const char* range_end = end_;
+    if (range_index < number_of_ranges) {
+      range_end = std::max(range_start,
+          position_ + total_size / number_of_ranges * range_index);
+      const char* newline = static_cast<const char*>(
+          memchr(range_end, '\n', end_ - range_end));
+      range_end = (newline == NULL) ? end_ : newline + 1;
+    }
+    ranges.push_back(Span(range_start, range_end));
+    range_start = range_end;
+  }
+  return ranges;
+}
+
+/** Reads the next block of the file behind the unread remainder of the
+ * buffer; enlarges the buffer if a single line does not fit in it. Returns
+ * false if nothing more could be read. **/
+bool VcfScanner::ReadNextBlock() {
+  size_t remainder = end_ - position_;
+  if (remainder > 0 && position_ != &buffer_[0]) {
+    memmove(&buffer_[0], position_, remainder);
+  }
+  if (remainder == buffer_.size()) {
+    buffer_.resize(2 * buffer_.size());
+  }
+  ssize_t bytes_read = 0;
+  if (decompressor_ != NULL) {
+    bytes_read = decompressor_->Read(&buffer_[remainder],
+        buffer_.size() - remainder);
+  }
+  else {
+    do {
+      bytes_read = read(file_descriptor_, &buffer_[remainder],
+          buffer_.size() - remainder);
+    } while (bytes_read < 0 && errno == EINTR);
+  }
+  position_ = &buffer_[0];
+  end_ = position_ + remainder;
+  if (bytes_read <= 0) {
+    is_exhausted_ = true;
+    return false;
+  }
+  end_ += bytes_read;
+  return true;
+}
+
+/** Puts the next line (without its line ending) into 'line'. Returns false
+ * when the end of the file has been reached. **/
+bool VcfScanner::NextLine(Span* line) {
+  while (true) {
+    const char* newline = (position_ == end_) ? NULL :
+        static_cast<const char*>(memchr(position_, '\n', end_ - position_));
+    if (newline == NULL && !is_exhausted_) {
+      ReadNextBlock();
+      continue;
+    }
+    if (newline == NULL && position_ == end_) {
+      return false;
+    }
+    const char* line_end = (newline == NULL) ? end_ : newline;
+    *line = Span(position_, line_end);
+    if (line_end > position_ && line_end[-1] == '\r') {
+      *line = Span(position_, line_end - 1);
+    }
+    const char* next_position = (newline == NULL) ? end_ : newline + 1;
+    offset_of_line_ = offset_;
+    offset_ += next_position - position_;
+    position_ = next_position;
+    return true;
+  }
+}
+
+/** Skips the text up to 'offset' (which should be the start of a line), for
+ * example to continue an interrupted analysis. A mapped file is not read at
+ * all; other inputs are read (and decompressed) but not split into lines.
+ * Aborts if the text is shorter than that. **/
+void VcfScanner::SkipTo(unsigned long long offset) {
+  Utilities::Require(offset >= offset_,
+      "VcfScanner::SkipTo error: cannot go back in the input.");
+  while (offset_ < offset) {
+    if (position_ == end_) {
+      Utilities::Require(!is_exhausted_ && ReadNextBlock(),
+          "VcfScanner::SkipTo error: the input is shorter than expected.");
+    }
+    size_t bytes_to_skip = std::min<unsigned long long>(end_ - position_,
+        offset - offset_);
+    position_ += bytes_to_skip;
+    offset_ += bytes_to_skip;
+  }
+}
@@ -0,0 +1,60 @@
+/*
+ * VcfScanner.h
+ *
+ * Hands out the lines of a VCF file as spans, without copying them. Regular
+ * files are memory-mapped; other inputs (pipes, for example) and
+ * gzip-compressed files are read in large blocks.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef VCFSCANNER_H_
+#define VCFSCANNER_H_
+
+#include <string>
+#include <vector>
+
+#include "BgzfReader.h"
+#include "Span.h"
+
+class VcfScanner {
+public:
+  VcfScanner(const std::string& name_of_input_file,
+      int number_of_threads = 1);
+  VcfScanner(const std::string& name_of_input_file,
+      const std::vector<BgzfReader::Chunk>& chunks, int number_of_threads);
+  VcfScanner(const Span& text);
+  virtual ~VcfScanner();
+
+  unsigned long long GetOffsetOfLine() const;
+  bool IsCompressed() const;
+  bool IsMapped() const;
+  bool IsOpen() const;
+  bool NextLine(Span* line);
+  void SkipTo(unsigned long long offset);
+  std::vector<Span> SplitIntoRanges(int number_of_ranges) const;
+
+private:
+  bool ReadNextBlock();
+
+  static const size_t BLOCK_SIZE = 1 << 22;
+
+  int file_descriptor_;
+  char* mapped_data_;
+  size_t mapped_size_;
+  bool is_exhausted_;
+
+  // the unread part of the mapping or of the block buffer
+  const char* position_;
+  const char* end_;
+  std::vector<char> buffer_;
+  // the offsets in the (decompressed) text of 'position_' and of the start
+  // of the last line handed out
+  unsigned long long offset_;
+  unsigned long long offset_of_line_;
+
+  // decompresses the input if it is gzip-compressed; NULL otherwise
+  BgzfReader* decompressor_;
+};
+
+#endif /* VCFSCANNER_H_ */
@@ -100,12 +100,53 @@ int main(int argc, char** argv) {
   std::cout << "Analyzing the genotypes from the given trio-based VCF\n";
   if (argc < 3) {
     std::cout << "Invalid number of arguments. At least one argument " <<
-        "is needed, the name of the input file. Other possible arguments " <<
+        "is needed, the name of the input file (which may be compressed " <<
+        "with gzip or bgzip). Other possible arguments " <<
         "are 'pindel' (to correctly process pindel VCFs with -1,X and 0,0 " <<
         "coverage), 'all', 'snp', 'sv', 'del', 'ins' to indicate the " <<
         "type, and 'sizegtX' (for example 'sizegt50') or sizeltY to " <<
         "indicate the size of the event (note: rpls are not filtered " <<
-        "on size yet).\n";
+        "on size yet). 'threads=N' analyzes the file with N threads, " <<
+        "'output=FILE' writes the analyzed records to FILE instead of " <<
+        "'output'. 'region=chr:start-end' (can be repeated) and " <<
+        "'bed=FILE' restrict the analysis to regions, reported " <<
+        "separately; a tabix or CSI index next to a bgzipped input file " <<
+        "is used to read only those regions. 'ped=FILE' takes the trios " <<
+        "from a PED file instead of from every three consecutive " <<
+        "samples. 'report=FILE' writes the time spent per stage and " <<
+        "thread, and the records and bytes processed, as JSON to FILE; " <<
+        "'report_interval=N' also does so every N seconds during the " <<
+        "run. 'checkpoint=FILE' saves the counts so far to FILE every " <<
+        "60 seconds (or every N seconds with 'checkpoint_interval=N'); " <<
+        "'resume=FILE' continues an interrupted run, given the same " <<
+        "arguments, from its last checkpoint. 'configurations=FILE' " <<
+        "also counts, in the same pass over the input, the " <<
+        "configurations in FILE: one per line, a name followed by " <<
+        "type, size and 'cX' arguments; their results go to " <<
+        "configuration_results.txt and to quality files with the name " <<
+        "of the configuration as suffix. 'sweep' also counts the calls " <<
+        "and trios for every minimal confidence from 0 to 1 in steps " <<
+        "of 0.01, and writes the call rate and Mendelian error rate per " <<
+        "threshold to confidence_sweep.txt. 'calibrate' does not read " <<
+        "the confidences from quality files, but calibrates them on the " <<
+        "input itself: a first pass counts the qualities of all calls, " <<
+        "a second pass analyzes the records again with the resulting " <<
+        "confidences. 'cache=FILE' analyzes FILE, a binary cache of the " <<
+        "parsed input file, instead of the input file itself; if FILE " <<
+        "does not exist yet, it is written first, so later runs on the " <<
+        "same input (with other types, sizes or confidences) do not have " <<
+        "to parse its text again. A cache of a file that has changed " <<
+        "since is refused; with input that is not a regular file (a " <<
+        "pipe), FILE is always written anew. Phased genotypes (0|1) are checked like " <<
+        "unphased ones, unless 'phased=father' or 'phased=mother' says " <<
+        "which parent the first allele of a phased child comes from; then " <<
+        "each allele of the child must be in the parent it is phased " <<
+        "to. A record with several alt alleles is analyzed if any of them " <<
+        "is of the type and size asked for; only its calls about such an " <<
+        "alt allele (homref and unknown calls are about any), and the " <<
+        "trios about one, are counted. A trio is about the alt allele of " <<
+        "the child, or else of the first parent with one, and its calls " <<
+        "are scored on the type and VAF of that allele.\n";
 
     return -1;
   } else {
@@ -118,7 +159,8 @@ int main(int argc, char** argv) {
     g_global_settings.Complete();
 
     std::cout << "input " << nameOfInputFile;
-    Analyzer analyzer(nameOfInputFile, &g_global_settings, "output");
+    Analyzer analyzer(nameOfInputFile, &g_global_settings,
+        g_global_settings.GetNameOfOutputFile());
     analyzer.analyze();
   }
 
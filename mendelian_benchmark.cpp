@@ -0,0 +1,384 @@
+/*
+ * mendelian_benchmark.cpp
+ *
+ * Measures the throughput of the stages of the analysis (parsing, genotype
+ * and support construction, call confidence, trio classification and
+ * output) on a synthetic trio VCF file, so that changes can be compared
+ * without real data. The stages run the code of the analyzer itself (see
+ * RecordClassifier), and the output goes through the OutputWriter to a
+ * file. The VCF file is generated in memory from a seed, so every run with
+ * the same options analyzes the same records. Before measuring, it checks
+ * that the delimiter indexes of all instruction sets agree on it.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BioUtils.h"
+#include "CallConfidenceEstimator.h"
+#include "DelimiterIndex.h"
+#include "Event.h"
+#include "FormatPlan.h"
+#include "OutputWriter.h"
+#include "Pedigree.h"
+#include "RecordClassifier.h"
+#include "Settings.h"
+#include "Span.h"
+#include "Statistics.h"
+#include "SyntheticVcfGenerator.h"
+#include "Utilities.h"
+#include "VcfRecord.h"
+#include "VcfScanner.h"
+
+namespace {
+
+enum Stage { kParse, kGenotyping, kConfidence, kClassification, kOutput };
+const int NUMBER_OF_STAGES = kOutput + 1;
+const char* const STAGE_NAMES[NUMBER_OF_STAGES] = { "parse",
+    "genotype/support", "confidence", "trio classification", "output" };
+
+// the records are taken through all stages in chunks of this size
+const size_t RECORDS_PER_CHUNK = 4096;
+
+struct BenchmarkOptions {
+  BenchmarkOptions() : number_of_runs(3),
+      name_of_output_file("benchmark_output") {}
+
+  SyntheticVcfOptions vcf;
+  // the type, size and confidence filters, phase order and 'pindel' of the
+  // analysis
+  Settings settings;
+  int number_of_runs;
+  std::string name_of_output_file;
+  std::string name_of_vcf_file;
+};
+
+// what one run of all stages measured and counted
+struct RunResults {
+  RunResults() : bytes_of_output(0) {
+    for (int stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+      seconds[stage] = 0.0;
+    }
+  }
+
+  double seconds[NUMBER_OF_STAGES];
+  size_t bytes_of_output;
+  Statistics statistics;
+};
+
+/** Returns the time in seconds since some fixed moment. **/
+double GetSeconds() {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Returns the number after the '=' of an argument; aborts if there is
+ * none. **/
+double GetValue(const std::string& argument) {
+  std::string value = argument.substr(argument.find('=') + 1);
+  char* end_of_number = NULL;
+  double number = strtod(value.c_str(), &end_of_number);
+  Utilities::Require(!value.empty() && *end_of_number == '\0',
+      "mendelian_benchmark error: '" + argument + "' needs a number.");
+  return number;
+}
+
+/** Adds a command line argument to the options; aborts if it is unknown. **/
+void AddArgument(const std::string& argument, BenchmarkOptions* options) {
+  SyntheticVcfOptions& vcf = options->vcf;
+  if (argument == "pindel" || argument == "gatk") {
+    vcf.is_pindel = (argument == "pindel");
+  } else if (Utilities::StringStartsWith(argument, "records=")) {
+    vcf.number_of_records = static_cast<long long>(GetValue(argument));
+  } else if (Utilities::StringStartsWith(argument, "trios=")) {
+    vcf.number_of_trios = static_cast<int>(GetValue(argument));
+  } else if (Utilities::StringStartsWith(argument, "snp=")) {
+    vcf.snp_weight = GetValue(argument);
+  } else if (Utilities::StringStartsWith(argument, "indel=")) {
+    vcf.indel_weight = GetValue(argument);
+  } else if (Utilities::StringStartsWith(argument, "sv=")) {
+    vcf.sv_weight = GetValue(argument);
+  } else if (Utilities::StringStartsWith(argument, "error=")) {
+    vcf.mendelian_error_rate = GetValue(argument);
+  } else if (Utilities::StringStartsWith(argument, "seed=")) {
+    vcf.seed = static_cast<unsigned int>(GetValue(argument));
+  } else if (Utilities::StringStartsWith(argument, "runs=")) {
+    options->number_of_runs = static_cast<int>(GetValue(argument));
+    Utilities::Require(options->number_of_runs > 0,
+        "mendelian_benchmark error: at least one run is needed.");
+  } else if (Utilities::StringStartsWith(argument, "delimiters=")) {
+    Utilities::Require(DelimiterIndex::UseInstructionSet(
+        argument.substr(11)), "mendelian_benchmark error: this processor "
+        "cannot build delimiter indexes with '" + argument.substr(11) +
+        "'.");
+  } else if (Utilities::StringStartsWith(argument, "vcf=")) {
+    options->name_of_vcf_file = argument.substr(4);
+  } else if (Utilities::StringStartsWith(argument, "output=")) {
+    options->name_of_output_file = argument.substr(7);
+    Utilities::Require(!options->name_of_output_file.empty(),
+        "mendelian_benchmark error: the name of the output file is empty.");
+  } else if (Utilities::StringStartsWith(argument, "phased=")) {
+    options->settings.Add(argument.c_str());
+  } else {
+    // a type, size or confidence filter, as for the analyzer
+    options->settings.AddFilter(argument.c_str());
+  }
+}
+
+/** Aborts unless the delimiter indexes built with every instruction set of
+ * this processor agree on the records of 'vcf', and on every beginning of
+ * its first record, so that texts end at every position of a word. **/
+void CheckDelimiterIndexes(const std::string& vcf) {
+  VcfScanner scanner((Span(vcf)));
+  long long number_of_texts = 0;
+  bool is_first_record = true;
+  Span line;
+  while (scanner.NextLine(&line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    size_t shortest_size = is_first_record ? 0 : line.size();
+    is_first_record = false;
+    for (size_t size = shortest_size; size <= line.size(); ++size) {
+      const char* instruction_set =
+          DelimiterIndex::FindDisagreeingInstructionSet(
+          Span(line.begin(), size));
+      if (instruction_set != NULL) {
+        Utilities::Require(false, "mendelian_benchmark error: the "
+            "delimiter index built with " + std::string(instruction_set) +
+            " differs from the one built one character at a time.");
+      }
+      ++number_of_texts;
+    }
+  }
+  std::cout << "Delimiter indexes of all instruction sets agree on " <<
+      number_of_texts << " texts\n";
+}
+
+/** Takes all records of 'vcf' through the stages of the analysis, chunk by
+ * chunk, timing each stage. Without a call confidence estimator, the
+ * confidence stage is skipped, and all calls count as confident. **/
+void RunStages(const std::string& vcf, const BenchmarkOptions& options,
+    const CallConfidenceEstimator* call_confidence_estimator,
+    RunResults* results) {
+  VcfScanner scanner((Span(vcf)));
+  TrioPlan trio_plan;
+  Pedigree::MakeConsecutiveTrioPlan(3 * options.vcf.number_of_trios,
+      &trio_plan);
+  const int number_of_samples = 3 * options.vcf.number_of_trios;
+  const Settings& settings = options.settings;
+  RecordClassifier classifier(&settings);
+  FormatPlan format_plan;
+  std::vector<Span> lines;
+  std::vector<VcfRecord> records(RECORDS_PER_CHUNK);
+  std::vector<Event> events;
+  std::vector<ParsedSamples> samples(RECORDS_PER_CHUNK);
+  std::vector<std::vector<signed char> > calls(RECORDS_PER_CHUNK);
+  // per record of the chunk, whether it passes the type and size filters,
+  // and whether it is written to the output file
+  std::vector<bool> is_analyzed(RECORDS_PER_CHUNK);
+  std::vector<bool> is_written(RECORDS_PER_CHUNK);
+  OutputWriter output_writer(options.name_of_output_file, false);
+  output_writer.Start(1, NULL);
+  std::string output_batch;
+  Statistics& statistics = results->statistics;
+
+  bool has_more_lines = true;
+  while (has_more_lines) {
+    double start = GetSeconds();
+    lines.clear();
+    events.clear();
+    Span line;
+    while (lines.size() < RECORDS_PER_CHUNK &&
+        (has_more_lines = scanner.NextLine(&line))) {
+      if (line.empty()) {
+        continue;
+      }
+      if (line[0] == '#') {
+        output_batch.append(line.begin(), line.size());
+        output_batch.push_back('\n');
+      } else {
+        lines.push_back(line);
+      }
+    }
+    for (size_t index = 0; index < lines.size(); ++index) {
+      VcfRecord& record = records[index];
+      record.Parse(lines[index]);
+      Span reference, alt;
+      BioUtils::GetDataAboutVariant(record, &reference, &alt);
+      events.push_back(Event(reference, alt));
+      is_analyzed[index] = settings.ShouldAnalyzeVariant(events[index]);
+      if (!is_analyzed[index]) {
+        continue;
+      }
+      record.ParseSamples();
+      Utilities::Require(record.GetNumberOfSamples() == number_of_samples,
+          "mendelian_benchmark error: a record has the wrong number of "
+          "samples.");
+    }
+    double end = GetSeconds();
+    results->seconds[kParse] += end - start;
+
+    start = end;
+    for (size_t index = 0; index < lines.size(); ++index) {
+      if (is_analyzed[index]) {
+        format_plan.SetFormat(records[index].GetColumn(kFormat));
+        classifier.ReadSamples(records[index], format_plan, trio_plan,
+            &samples[index]);
+      }
+    }
+    end = GetSeconds();
+    results->seconds[kGenotyping] += end - start;
+
+    start = end;
+    for (size_t index = 0; index < lines.size(); ++index) {
+      if (!is_analyzed[index]) {
+        continue;
+      }
+      if (call_confidence_estimator != NULL) {
+        classifier.EstimateConfidences(*call_confidence_estimator,
+            events[index], &samples[index]);
+      } else {
+        samples[index].confidences.assign(samples[index].results.size(),
+            1.0);
+      }
+    }
+    end = GetSeconds();
+    results->seconds[kConfidence] += end - start;
+
+    start = end;
+    for (size_t index = 0; index < lines.size(); ++index) {
+      is_written[index] = is_analyzed[index] && classifier.ClassifySamples(
+          samples[index], events[index], trio_plan, settings, &calls[index],
+          &statistics);
+    }
+    end = GetSeconds();
+    results->seconds[kClassification] += end - start;
+
+    start = end;
+    for (size_t index = 0; index < lines.size(); ++index) {
+      if (is_written[index]) {
+        const VcfRecord& record = records[index];
+        classifier.AppendRecord(Span(record.GetLine().begin(),
+            record.GetColumn(kInfo).end()), samples[index], calls[index],
+            &output_batch);
+      }
+    }
+    if (output_batch.size() >= OutputWriter::BATCH_SIZE || !has_more_lines) {
+      results->bytes_of_output += output_batch.size();
+      output_writer.Submit(0, &output_batch);
+    }
+    if (!has_more_lines) {
+      output_writer.CloseStream(0);
+      output_writer.Finish();
+    }
+    end = GetSeconds();
+    results->seconds[kOutput] += end - start;
+  }
+}
+
+/** Shows a line of the table of results. **/
+void ShowStage(const std::string& name, double seconds,
+    long long number_of_records, size_t number_of_bytes) {
+  std::cout << std::left << std::setw(22) << name << std::right <<
+      std::fixed << std::setprecision(4) << std::setw(10) << seconds;
+  if (seconds > 0) {
+    std::cout << std::setprecision(0) << std::setw(14) <<
+        number_of_records / seconds << std::setprecision(1) <<
+        std::setw(10) << number_of_bytes / seconds / 1e6;
+  }
+  std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  BenchmarkOptions options;
+  for (int argument_index = 1; argument_index < argc; ++argument_index) {
+    AddArgument(argv[argument_index], &options);
+  }
+  if (options.vcf.is_pindel) {
+    options.settings.Add("pindel");
+  }
+  options.settings.Complete();
+
+  std::cout << "Generating " << options.vcf.number_of_records << " " <<
+      (options.vcf.is_pindel ? "pindel" : "GATK") << " records of " <<
+      options.vcf.number_of_trios << " trio(s), seed " << options.vcf.seed <<
+      "; delimiters found with " << DelimiterIndex::GetInstructionSet() <<
+      "\n";
+  SyntheticVcfGenerator generator(options.vcf);
+  std::string vcf;
+  generator.AppendHeader(&vcf);
+  while (generator.AppendRecord(&vcf)) {
+  }
+  CheckDelimiterIndexes(vcf);
+  if (!options.name_of_vcf_file.empty()) {
+    std::ofstream vcf_file(options.name_of_vcf_file.c_str(),
+        std::ios::binary);
+    vcf_file.write(vcf.data(), vcf.size());
+    Utilities::Require(vcf_file.good(), "mendelian_benchmark error: cannot "
+        "write '" + options.name_of_vcf_file + "'.");
+  }
+
+  // the estimator reads its tables from the working directory
+  CallConfidenceEstimator* call_confidence_estimator = NULL;
+  if (std::ifstream("coverage_qualities.txt").good() &&
+      std::ifstream("vaf_qualities.txt").good()) {
+    call_confidence_estimator = new CallConfidenceEstimator();
+  }
+  else {
+    std::cout << "No quality files in the working directory, skipping the "
+        "confidence stage\n";
+  }
+
+  // of every stage, the fastest of the runs counts
+  RunResults best;
+  for (int run = 0; run < options.number_of_runs; ++run) {
+    RunResults results;
+    RunStages(vcf, options, call_confidence_estimator, &results);
+    for (int stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+      if (run == 0 || results.seconds[stage] < best.seconds[stage]) {
+        best.seconds[stage] = results.seconds[stage];
+      }
+    }
+    if (run == 0) {
+      best.bytes_of_output = results.bytes_of_output;
+      best.statistics = results.statistics;
+    }
+  }
+
+  std::cout << "Input: " << vcf.size() / 1e6 << " MB, output: " <<
+      best.bytes_of_output / 1e6 << " MB; best of " <<
+      options.number_of_runs << " run(s)\n";
+  std::cout << std::left << std::setw(22) << "stage" << std::right <<
+      std::setw(10) << "seconds" << std::setw(14) << "records/s" <<
+      std::setw(10) << "MB/s" << "\n";
+  double total_seconds = 0.0;
+  for (int stage = 0; stage < NUMBER_OF_STAGES; ++stage) {
+    if (stage == kConfidence && call_confidence_estimator == NULL) {
+      continue;
+    }
+    ShowStage(STAGE_NAMES[stage], best.seconds[stage],
+        options.vcf.number_of_records, vcf.size());
+    total_seconds += best.seconds[stage];
+  }
+  ShowStage("total", total_seconds, options.vcf.number_of_records,
+      vcf.size());
+
+  const Statistics& statistics = best.statistics;
+  std::cout << "Trios: " << statistics.mendelian_correct << " correct, " <<
+      statistics.mendelian_error << " Mendelian errors, " <<
+      statistics.all_homref << " all hom-ref, " << statistics.unknown_count <<
+      " not assessable\n";
+  delete call_confidence_estimator;
+  return 0;
+}